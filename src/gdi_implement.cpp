@@ -3,6 +3,7 @@
 #include <array>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <Windows.h>
 #include <Windowsx.h>
 #include <gdiplus.h>
@@ -60,6 +61,7 @@ namespace
     {
         std::string name;
         Gdiplus::Image * image;
+        HBITMAP target = nullptr;
     };
     struct window
     {
@@ -68,6 +70,8 @@ namespace
         xui::rect rrect;
         eventmap events;
         HBITMAP frame_buffer = nullptr;
+        bool invalid = true;
+        std::vector<xui::rect> damages;
     };
     struct font
     {
@@ -232,6 +236,8 @@ struct gdi_implement::private_p
     std::vector<font> _fonts;
     std::vector<window> _windows;
     std::vector<texture> _textures;
+    std::vector<std::shared_ptr<Gdiplus::Pen>> _pens;
+    std::vector<std::shared_ptr<Gdiplus::Brush>> _brushes;
     Gdiplus::PrivateFontCollection _collection;
     std::array<Gdiplus::FontFamily, 100> _familys;
 };
@@ -269,7 +275,7 @@ void gdi_implement::init()
     _p->_hdc = CreateCompatibleDC( nullptr );
 }
 
-void gdi_implement::update( const std::function<std::span<xui::drawcmd>()> & paint )
+void gdi_implement::update( const std::function<const xui::drawlist &()> & paint )
 {
     MSG msg;
     while ( 1 )
@@ -607,6 +613,7 @@ void gdi_implement::set_window_status( xui::window_id id, xui::window_status sho
         
         DeleteObject( _p->_windows[id].frame_buffer );
         _p->_windows[id].frame_buffer = CreateBitmap( _p->_windows[id].rect.w, _p->_windows[id].rect.h, 1, 32, nullptr );
+        _p->_windows[id].invalid = true;
     }
         break;
     }
@@ -637,6 +644,7 @@ void gdi_implement::set_window_rect( xui::window_id id, const xui::rect & rect )
     {
         DeleteObject( _p->_windows[id].frame_buffer );
         _p->_windows[id].frame_buffer = CreateBitmap( _p->_windows[id].rect.w, _p->_windows[id].rect.h, 1, 32, nullptr );
+        _p->_windows[id].invalid = true;
     }
 }
 
@@ -830,8 +838,80 @@ void gdi_implement::remove_texture( xui::texture_id id )
         return;
 
     if ( _p->_textures[id].image ) delete _p->_textures[id].image;
+    if ( _p->_textures[id].target ) DeleteObject( _p->_textures[id].target );
 
     _p->_textures[id].image = nullptr;
+    _p->_textures[id].target = nullptr;
+}
+
+xui::texture_id gdi_implement::create_render_target( int width, int height )
+{
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof( BITMAPINFOHEADER );
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void * bits = nullptr;
+    HBITMAP target = CreateDIBSection( _p->_hdc, &info, DIB_RGB_COLORS, &bits, nullptr, 0 );
+    if ( target == nullptr )
+        return xui::invalid_texture_id;
+
+    xui::texture_id id = xui::invalid_texture_id;
+
+    for ( size_t i = 0; i < _p->_textures.size(); i++ )
+    {
+        if ( _p->_textures[i].image == nullptr )
+        {
+            id = i;
+            break;
+        }
+    }
+    if ( id == xui::invalid_texture_id )
+    {
+        _p->_textures.push_back( {} );
+        id = _p->_textures.size() - 1;
+    }
+
+    // the image shares the section memory, drawing into the section updates the texture
+    texture tex;
+
+    tex.name = "render-target://" + std::to_string( id );
+    tex.image = new Gdiplus::Bitmap( width, height, width * 4, PixelFormat32bppPARGB, (BYTE *)bits );
+    tex.target = target;
+
+    _p->_textures[id] = tex;
+
+    return id;
+}
+
+void gdi_implement::update_render_target( xui::texture_id id, const xui::drawlist & list )
+{
+    if ( id >= _p->_textures.size() || _p->_textures[id].target == nullptr )
+        return;
+
+    auto & tex = _p->_textures[id];
+    std::vector<std::unique_ptr<Gdiplus::Region>> clips( 1 );
+    clips[0] = std::make_unique<Gdiplus::Region>( Gdiplus::RectF( 0, 0, (float)tex.image->GetWidth(), (float)tex.image->GetHeight() ) );
+
+    HGDIOBJ old_bitmap = SelectObject( _p->_hdc, (HGDIOBJ)tex.target );
+    {
+        Gdiplus::Graphics g( _p->_hdc );
+        g.Clear( Gdiplus::Color( 0, 0, 0, 0 ) );
+    }
+    SelectObject( _p->_hdc, old_bitmap );
+
+    std::vector<void *> buffers( 1, tex.target );
+    draw( list, buffers, clips );
+
+    GdiFlush();
+}
+
+void gdi_implement::remove_render_target( xui::texture_id id )
+{
+    remove_texture( id );
 }
 
 std::string gdi_implement::get_clipboard_data( xui::window_id id, std::string_view mime ) const
@@ -922,10 +1002,48 @@ std::span<xui::vec2> gdi_implement::get_touchs( xui::window_id id ) const
     return _p->_windows[id].events._touchs;
 }
 
+void gdi_implement::create_paint( xui::paint_id id, const xui::border & stroke )
+{
+    if ( id >= _p->_pens.size() )
+        _p->_pens.resize( id + 1 );
+
+    _p->_pens[id] = create_pen( stroke );
+}
+
+void gdi_implement::create_paint( xui::paint_id id, const xui::filled & fill )
+{
+    if ( id >= _p->_brushes.size() )
+        _p->_brushes.resize( id + 1 );
+
+    _p->_brushes[id] = fill.colors.index() != 0 ? create_brush( fill ) : nullptr;
+}
+
+void gdi_implement::remove_paint( xui::paint_id id )
+{
+    if ( id < _p->_pens.size() )
+        _p->_pens[id] = nullptr;
+    if ( id < _p->_brushes.size() )
+        _p->_brushes[id] = nullptr;
+}
+
+void gdi_implement::damage_window( xui::window_id id, std::span<const xui::rect> rects )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    _p->_windows[id].damages.insert( _p->_windows[id].damages.end(), rects.begin(), rects.end() );
+}
+
 void gdi_implement::present()
 {
     for ( auto & it : _p->_windows )
     {
+        if ( !it.invalid && it.damages.empty() )
+        {
+            it.events.flush();
+            continue;
+        }
+
         HGDIOBJ old_bitmap = SelectObject( _p->_hdc, (HGDIOBJ)it.frame_buffer );
         {
             POINT point = { 0, 0 };
@@ -941,16 +1059,59 @@ void gdi_implement::present()
         }
         SelectObject( _p->_hdc, old_bitmap );
 
+        it.invalid = false;
+        it.damages.clear();
         it.events.flush();
     }
 }
 
-void gdi_implement::render( std::span<xui::drawcmd> cmds )
+void gdi_implement::render( const xui::drawlist & list )
+{
+    std::vector<std::unique_ptr<Gdiplus::Region>> clips( _p->_windows.size() );
+
+    for ( size_t i = 0; i < _p->_windows.size(); i++ )
+    {
+        auto & w = _p->_windows[i];
+        if ( w.hwnd == nullptr || ( !w.invalid && w.damages.empty() ) )
+            continue;
+
+        if ( w.invalid )
+        {
+            clips[i] = std::make_unique<Gdiplus::Region>( Gdiplus::RectF( 0, 0, w.rect.w, w.rect.h ) );
+        }
+        else
+        {
+            clips[i] = std::make_unique<Gdiplus::Region>();
+            clips[i]->MakeEmpty();
+            for ( const auto & it : w.damages )
+                clips[i]->Union( Gdiplus::RectF( it.x, it.y, it.w, it.h ) );
+        }
+
+        HGDIOBJ old_bitmap = SelectObject( _p->_hdc, (HGDIOBJ)w.frame_buffer );
+        {
+            Gdiplus::Graphics g( _p->_hdc );
+            g.SetClip( clips[i].get() );
+            g.Clear( Gdiplus::Color( 0, 0, 0, 0 ) );
+        }
+        SelectObject( _p->_hdc, old_bitmap );
+    }
+
+    std::vector<void *> buffers( _p->_windows.size() );
+    for ( size_t i = 0; i < _p->_windows.size(); i++ )
+        buffers[i] = _p->_windows[i].frame_buffer;
+
+    draw( list, buffers, clips );
+}
+
+void gdi_implement::draw( const xui::drawlist & list, std::span<void * const> buffers, std::span<const std::unique_ptr<Gdiplus::Region>> clips )
 {
     HGDIOBJ old_obj = nullptr;
     xui::window_id id = xui::invalid_window_id;
 
-    for ( const auto & cmd : cmds )
+    _p->_pens.resize( std::max( _p->_pens.size(), list.strokes.size() ) );
+    _p->_brushes.resize( std::max( _p->_brushes.size(), list.fills.size() ) );
+
+    for ( const auto & cmd : list )
     {
         if ( id != cmd.id )
         {
@@ -958,20 +1119,31 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
 
             if( old_obj != nullptr ) SelectObject( _p->_hdc, old_obj );
 
-            old_obj = SelectObject( _p->_hdc, (HGDIOBJ)_p->_windows[cmd.id].frame_buffer );
+            old_obj = SelectObject( _p->_hdc, (HGDIOBJ)buffers[cmd.id] );
         }
 
-        if ( cmd.id < _p->_windows.size() && _p->_windows[cmd.id].hwnd != nullptr )
+        if ( cmd.id < clips.size() && clips[cmd.id] != nullptr )
         {
-            std::visit( xui::overload(
-            [&]( std::monostate )
-            {
-
-            },
+            const auto & border = list.stroke( cmd );
+            const auto & filled = list.fill( cmd );
+            const auto & clip = list.clip( cmd );
+            Gdiplus::RectF clip_rect( clip.x, clip.y, clip.w, clip.h );
+
+            // texture brushes whose image was not loaded yet when the paint was created are built on first use
+            auto & pen = _p->_pens[cmd.stroke];
+            auto & brush = _p->_brushes[cmd.fill];
+            if ( pen == nullptr )
+                pen = create_pen( border );
+            if ( brush == nullptr && filled.colors.index() != 0 )
+                brush = create_brush( filled );
+
+            list.visit( cmd, xui::overload(
             [&]( const xui::drawcmd::text_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
                 Gdiplus::SolidBrush brush( Gdiplus::Color( element.color.a, element.color.r, element.color.g, element.color.b ) );
 
@@ -999,104 +1171,78 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
-                auto pen = create_pen( element.stroke );
                 g.DrawLine( pen.get(), Gdiplus::PointF{ element.p1.x, element.p1.y }, Gdiplus::PointF{ element.p2.x, element.p2.y } );
             },
             [&]( const xui::drawcmd::rect_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
                 Gdiplus::GraphicsPath path;
 
                 float radius = 0;
 
-                radius = 2 * element.border.radius.x;
+                radius = 2 * border.radius.x;
                 path.AddArc( element.rect.x, element.rect.y, radius, radius, 180, 90 );
-                path.AddLine( element.rect.x + element.border.radius.x, element.rect.y, element.rect.x + element.rect.w - element.border.radius.y, element.rect.y );
+                path.AddLine( element.rect.x + border.radius.x, element.rect.y, element.rect.x + element.rect.w - border.radius.y, element.rect.y );
 
-                radius = 2 * element.border.radius.y;
+                radius = 2 * border.radius.y;
                 path.AddArc( element.rect.x + element.rect.w - radius, element.rect.y, radius, radius, 270, 90 );
-                path.AddLine( element.rect.x + element.rect.w, element.rect.y + element.border.radius.y, element.rect.x + element.rect.w, element.rect.y + element.rect.h - element.border.radius.z );
+                path.AddLine( element.rect.x + element.rect.w, element.rect.y + border.radius.y, element.rect.x + element.rect.w, element.rect.y + element.rect.h - border.radius.z );
 
-                radius = 2 * element.border.radius.z;
+                radius = 2 * border.radius.z;
                 path.AddArc( element.rect.x + element.rect.w - radius, element.rect.y + element.rect.h - radius, radius, radius, 0, 90 );
-                path.AddLine( element.rect.x + element.rect.w - element.border.radius.z, element.rect.y + element.rect.h, element.rect.x + element.border.radius.w, element.rect.y + element.rect.h );
+                path.AddLine( element.rect.x + element.rect.w - border.radius.z, element.rect.y + element.rect.h, element.rect.x + border.radius.w, element.rect.y + element.rect.h );
 
-                radius = 2 * element.border.radius.w;
+                radius = 2 * border.radius.w;
                 path.AddArc( element.rect.x, element.rect.y + element.rect.h - radius, radius, radius, 90, 90 );
-                path.AddLine( element.rect.x, element.rect.y + element.rect.h - element.border.radius.w, element.rect.x, element.rect.y + element.border.radius.x );
+                path.AddLine( element.rect.x, element.rect.y + element.rect.h - border.radius.w, element.rect.x, element.rect.y + border.radius.x );
 
-                if ( element.filled.colors.index() != 0 )
+                if ( brush != nullptr )
                 {
-                    g.FillPath( create_brush( element.filled ).get(), &path );
+                    g.FillPath( brush.get(), &path );
                 }
 
-                g.DrawPath( create_pen( element.border ).get(), &path );
+                g.DrawPath( pen.get(), &path );
             },
             [&]( const xui::drawcmd::path_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
                 Gdiplus::GraphicsPath path;
 
-                auto it = element.data.begin();
-                auto f = []( auto & it )
-                {
-                    auto beg = it;
-                    if ( *it == '-' || *it == '+' ) it++;
-                    while ( std::isdigit( *it ) || *it == '.' ) it++;
-
-                    float value = 0;
-                    std::from_chars( beg.operator->(), it.operator->(), value );
-                    return value;
-                };
-                auto ppoint = [f]( auto & it ) -> xui::vec2
-                {
-                    xui::vec2 p;
-
-                    p.x = f( it );
-                    it++;
-                    p.y = f( it );
-
-                    if ( *it == ' ' )
-                        it++;
-
-                    return p;
-                };
+                auto pt = element.points.data();
                 xui::vec2 m, c;
 
-                while ( it != element.data.end() )
+                for ( auto cmd : element.commands )
                 {
-                    if ( element.data.find( '-' ) != std::string::npos )
+                    switch ( cmd )
                     {
-                        int i = 0;
-                    }
-                    switch ( *it )
-                    {
-                    case 'M':
+                    case xui::drawcmd::path_element::MOVETO:
                     {
-                        it++;
-                        m = ppoint( it );
+                        m = pt[0];
                     }
                     break;
-                    case 'L':
+                    case xui::drawcmd::path_element::LINETO:
                     {
-                        it++;
-                        auto p = ppoint( it );
+                        auto p = pt[0];
                         path.AddLine( Gdiplus::PointF( m.x, m.y ), Gdiplus::PointF( p.x, p.y ) );
                         m = p;
                     }
                     break;
-                    case 'C':
+                    case xui::drawcmd::path_element::CURVETO:
                     {
-                        it++;
-
-                        auto c1 = ppoint( it );
-                        auto c2 = ppoint( it );
-                        auto e = ppoint( it );
+                        auto c1 = pt[0];
+                        auto c2 = pt[1];
+                        auto e = pt[2];
 
                         Gdiplus::PointF points[4];
                         points[0] = { m.x, m.y };
@@ -1110,13 +1256,11 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
                         c = c2;
                     }
                         break;
-                    case 'S':
+                    case xui::drawcmd::path_element::SMOOTH_CURVETO:
                     {
-                        it++;
-
                         auto c1 = c;
-                        auto c2 = ppoint( it );
-                        auto e = ppoint( it );
+                        auto c2 = pt[0];
+                        auto e = pt[1];
 
                         Gdiplus::PointF points[4];
                         points[0] = { m.x, m.y };
@@ -1130,12 +1274,10 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
                         c = {};
                     }
                         break;
-                    case 'Q':
+                    case xui::drawcmd::path_element::QUADRATIC_CURVETO:
                     {
-                        it++;
-
-                        c = ppoint( it );
-                        auto e = ppoint( it );
+                        c = pt[0];
+                        auto e = pt[1];
 
                         Gdiplus::PointF points[4];
                         points[0] = { m.x, m.y };
@@ -1148,11 +1290,9 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
                         m = e;
                     }
                         break;
-                    case 'T':
+                    case xui::drawcmd::path_element::SMOOTH_QUADRATIC_CURVETO:
                     {
-                        it++;
-
-                        auto e = ppoint( it );
+                        auto e = pt[0];
 
                         Gdiplus::PointF points[4];
                         points[0] = { m.x, m.y };
@@ -1166,34 +1306,31 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
                         c = {};
                     }
                         break;
-                    case 'Z':
+                    case xui::drawcmd::path_element::CLOSEPATH:
                     {
-                        it++;
                         m = {};
                         path.CloseFigure();
                         path.StartFigure();
                     }
                     break;
-                    case ' ':
-                        it++;
-                        break;
-                    default:
-                        throw "";
-                        break;
                     }
+
+                    pt += xui::drawcmd::path_element::point_count( cmd );
                 }
 
-                if ( element.filled.colors.index() != 0 )
+                if ( brush != nullptr )
                 {
-                    g.FillPath( create_brush( element.filled ).get(), &path );
+                    g.FillPath( brush.get(), &path );
                 }
 
-                g.DrawPath( create_pen( element.stroke ).get(), &path );
+                g.DrawPath( pen.get(), &path );
             },
             [&]( const xui::drawcmd::image_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
                 g.DrawImage( _p->_textures[element.id].image, Gdiplus::RectF( element.rect.x, element.rect.y, element.rect.w, element.rect.h ) );
             },
@@ -1201,30 +1338,36 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
-                if ( element.filled.colors.index() != 0 )
+                if ( brush != nullptr )
                 {
-                    g.FillEllipse( create_brush( element.filled ).get(), element.center.x - element.radius, element.center.y - element.radius, element.radius * 2, element.radius * 2 );
+                    g.FillEllipse( brush.get(), element.center.x - element.radius, element.center.y - element.radius, element.radius * 2, element.radius * 2 );
                 }
 
-                g.DrawEllipse( create_pen( element.border ).get(), element.center.x - element.radius, element.center.y - element.radius, element.radius * 2, element.radius * 2 );
+                g.DrawEllipse( pen.get(), element.center.x - element.radius, element.center.y - element.radius, element.radius * 2, element.radius * 2 );
             },
             [&]( const xui::drawcmd::ellipse_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
-                if ( element.filled.colors.index() != 0 )
+                if ( brush != nullptr )
                 {
-                    g.FillEllipse( create_brush( element.filled ).get(), element.center.x - element.radius.x, element.center.y - element.radius.y, element.radius.x * 2, element.radius.y * 2 );
+                    g.FillEllipse( brush.get(), element.center.x - element.radius.x, element.center.y - element.radius.y, element.radius.x * 2, element.radius.y * 2 );
                 }
 
-                g.DrawEllipse( create_pen( element.border ).get(), element.center.x - element.radius.x, element.center.y - element.radius.y, element.radius.x * 2, element.radius.y * 2 );
+                g.DrawEllipse( pen.get(), element.center.x - element.radius.x, element.center.y - element.radius.y, element.radius.x * 2, element.radius.y * 2 );
             },
             [&]( const xui::drawcmd::polygon_element & element )
             {
                 Gdiplus::Graphics g( _p->_hdc );
                 g.SetSmoothingMode( Gdiplus::SmoothingModeHighQuality );
+                g.SetClip( clips[cmd.id].get() );
+                g.IntersectClip( clip_rect );
 
                 std::vector<Gdiplus::PointF> points;
                 for ( const auto & it : element.points )
@@ -1232,14 +1375,14 @@ void gdi_implement::render( std::span<xui::drawcmd> cmds )
                     points.push_back( { it.x, it.y } );
                 }
 
-                if ( element.filled.colors.index() != 0 )
+                if ( brush != nullptr )
                 {
-                    g.FillPolygon( create_brush( element.filled ).get(), points.data(), points.size() );
+                    g.FillPolygon( brush.get(), points.data(), points.size() );
                 }
 
-                g.DrawPolygon( create_pen( element.border ).get(), points.data(), points.size() );
+                g.DrawPolygon( pen.get(), points.data(), points.size() );
             }
-            ), cmd.element );
+            ) );
         }
     }
     
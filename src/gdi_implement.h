@@ -6,16 +6,17 @@ namespace Gdiplus
 {
 	class Pen;
 	class Brush;
+	class Region;
 }
 
 namespace system_resource
 {
-	static constexpr xui::control_id FONT_DEFAULT = "font://default";
+	static constexpr std::string_view FONT_DEFAULT = "font://default";
 
-	static constexpr xui::control_id ICON_APPLICATION = "icon://application";
-	static constexpr xui::control_id ICON_ERROR = "icon://error";
-	static constexpr xui::control_id ICON_WARNING = "icon://warning";
-	static constexpr xui::control_id ICON_INFORMATION = "icon://information";
+	static constexpr std::string_view ICON_APPLICATION = "icon://application";
+	static constexpr std::string_view ICON_ERROR = "icon://error";
+	static constexpr std::string_view ICON_WARNING = "icon://warning";
+	static constexpr std::string_view ICON_INFORMATION = "icon://information";
 }
 
 class gdi_implement : public xui::implement
@@ -29,7 +30,7 @@ public:
 
 public:
 	void init();
-	void update( const std::function<std::span<xui::drawcmd>()> & paint );
+	void update( const std::function<const xui::drawlist &()> & paint );
 	void release();
 
 public:
@@ -65,9 +66,23 @@ public:
 	std::string get_clipboard_data( xui::window_id id, std::string_view mime ) const override;
 	bool set_clipboard_data( xui::window_id id, std::string_view mime, std::string_view data ) override;
 
+public:
+	void create_paint( xui::paint_id id, const xui::border & stroke ) override;
+	void create_paint( xui::paint_id id, const xui::filled & fill ) override;
+	void remove_paint( xui::paint_id id ) override;
+
+public:
+	xui::texture_id create_render_target( int width, int height ) override;
+	void update_render_target( xui::texture_id id, const xui::drawlist & list ) override;
+	void remove_render_target( xui::texture_id id ) override;
+
+public:
+	void damage_window( xui::window_id id, std::span<const xui::rect> rects ) override;
+
 private:
 	void present();
-	void render( std::span<xui::drawcmd> cmds );
+	void render( const xui::drawlist & list );
+	void draw( const xui::drawlist & list, std::span<void * const> buffers, std::span<const std::unique_ptr<Gdiplus::Region>> clips );
 
 private:
 	std::shared_ptr<Gdiplus::Pen> create_pen( const xui::stroke & stroke ) const;
@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <iostream>
+#include "software_implement.h"
+
+class headless_list : public xui::listview_model
+{
+public:
+	headless_list()
+		: xui::listview_model( "headless_list" )
+	{
+	}
+
+public:
+	int row_count( xui::control_id parent ) const override
+	{
+		return parent.empty() ? 1000000 : 0;
+	}
+	value_t item_data( xui::control_id id, int role ) override
+	{
+		return role == NAME ? value_t( std::string( "row" ) ) : value_t();
+	}
+	void item_data( xui::control_id id, int role, const value_t & val ) override
+	{
+	}
+};
+
+class headless_table : public xui::tableview_model
+{
+public:
+	headless_table()
+		: xui::tableview_model( "headless_table" )
+	{
+	}
+
+public:
+	int row_count( xui::control_id parent ) const override
+	{
+		return parent.empty() ? 1000 : 0;
+	}
+	int col_count( xui::control_id parent ) const override
+	{
+		return parent.empty() ? 4 : 0;
+	}
+	value_t item_data( xui::control_id id, int role ) override
+	{
+		return role == NAME ? value_t( std::string( "cell" ) ) : value_t();
+	}
+	void item_data( xui::control_id id, int role, const value_t & val ) override
+	{
+	}
+};
+
+static bool radio_value = true;
+static float slider_value = 0.5f;
+
+// renders one frame through the software backend and writes it as a binary ppm
+int main( int argc, char ** argv )
+{
+	xui::context ctx;
+	software_implement imp;
+	xui::style style;
+	style.parse( xui::context::dark_style() );
+
+	imp.init();
+	ctx.init( &imp );
+	auto font = imp.create_font( "font://default", 16, xui::font_flag::FONT_NONE );
+	auto window = imp.create_window( "XUI", xui::invalid_texture_id, { 0, 0, 600, 600 } );
+
+	headless_list list_m;
+	headless_table table_m;
+	int list_rows = 0, table_cells = 0;
+
+	imp.update( [&]() -> const xui::drawlist &
+	{
+		ctx.begin();
+		{
+			auto rect = imp.get_window_rect( window );
+			ctx.push_style( &style );
+			ctx.push_font_id( font );
+			ctx.push_window_id( window );
+			ctx.push_viewport( { 0, 0, rect.w, rect.h } );
+			{
+				ctx.push_viewport( { 20, 20, 100, 30 } );
+				ctx.label( "headless" );
+				ctx.pop_viewport();
+
+				ctx.push_viewport( { 20, 60, 100, 30 } );
+				ctx.button( "button" );
+				ctx.pop_viewport();
+
+				ctx.push_viewport( { 20, 100, 150, 20 } );
+				ctx.slider( slider_value, 0, 1 );
+				ctx.pop_viewport();
+
+				ctx.push_viewport( { 20, 130, 20, 20 } );
+				ctx.check( radio_value );
+				ctx.pop_viewport();
+
+				ctx.push_viewport( { 200, 20, 200, 250 } );
+				if ( ctx.begin_listview( &list_m ) )
+				{
+					int row;
+					while ( ctx.listview_item( row ) )
+						list_rows++;
+				}
+				ctx.end_listview();
+				ctx.pop_viewport();
+
+				ctx.push_viewport( { 200, 300, 380, 280 } );
+				if ( ctx.begin_tableview( &table_m ) )
+				{
+					int row, col;
+					ctx.tableview_header();
+					while ( ctx.tableview_item( row, col ) )
+						table_cells++;
+				}
+				ctx.end_tableview();
+				ctx.pop_viewport();
+			}
+			ctx.pop_viewport();
+			ctx.pop_window_id();
+			ctx.pop_font_id();
+			ctx.pop_style();
+		}
+		return ctx.end();
+	} );
+
+	std::cout << "listview rows " << list_rows << ", tableview cells " << table_cells << std::endl;
+
+	// the pixels are premultiplied, dropping alpha composites them over black
+	auto rect = imp.get_window_rect( window );
+	auto pixels = imp.get_window_pixels( window );
+	if ( argc > 1 )
+	{
+		if ( auto file = std::fopen( argv[1], "wb" ) )
+		{
+			std::fprintf( file, "P6\n%d %d\n255\n", (int)rect.w, (int)rect.h );
+			for ( auto pixel : pixels )
+			{
+				xui::color c;
+				c.hex = pixel;
+				std::fputc( c.r, file );
+				std::fputc( c.g, file );
+				std::fputc( c.b, file );
+			}
+			std::fclose( file );
+		}
+	}
+
+	ctx.release();
+	imp.release();
+
+	return list_rows > 0 && table_cells > 0 ? 0 : 1;
+}
@@ -24,7 +24,7 @@ int main()
 	auto icon = imp.create_texture( system_resource::ICON_APPLICATION );
 	auto window = imp.create_window( "XUI", icon, { 500, 300, 600, 600 } );
 
-	imp.update( [&]()
+	imp.update( [&]() -> const xui::drawlist &
 	{
 		ctx.begin();
 		{
@@ -66,7 +66,7 @@ int main()
 					menubar_value = xui::invalid_control_id;
 					if ( ctx.menubar( &menubar_m, menubar_value ) )
 					{
-						std::cout << "menubar action " << menubar_value << std::endl;
+						std::cout << "menubar action " << menubar_value.hash() << std::endl;
 					}
 
 					ctx.push_viewport( { 100, 100, 100, 100 } );
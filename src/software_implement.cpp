@@ -0,0 +1,2604 @@
+#include "software_implement.h"
+
+#include <array>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <condition_variable>
+
+#if !defined( XUI_SOFTWARE_NO_SIMD ) && ( defined( __x86_64__ ) || defined( _M_X64 ) )
+#define XUI_SOFTWARE_X64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define XUI_TARGET_AVX2
+#else
+#define XUI_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#endif
+#endif
+
+namespace
+{
+    static constexpr int TILE_SIZE = 64;
+    static constexpr std::string_view FONT_DEFAULT = "font://default";
+
+    static constexpr std::array<const char *, 5> default_font_files =
+    {
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/TTF/DejaVuSans.ttf",
+        "/System/Library/Fonts/Supplemental/Arial.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+    };
+
+    // 8x8 patterns for filled::DENSE1 .. filled::DIAGCROSS, msb is the leftmost pixel
+    static constexpr std::array<std::array<std::uint8_t, 8>, 13> hatch_masks =
+    { {
+        { 0x88, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00 },
+        { 0x88, 0x22, 0x88, 0x22, 0x88, 0x22, 0x88, 0x22 },
+        { 0xAA, 0x44, 0xAA, 0x11, 0xAA, 0x44, 0xAA, 0x11 },
+        { 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55 },
+        { 0x55, 0xBB, 0x55, 0xEE, 0x55, 0xBB, 0x55, 0xEE },
+        { 0x77, 0xDD, 0x77, 0xDD, 0x77, 0xDD, 0x77, 0xDD },
+        { 0x77, 0xFF, 0xDD, 0xFF, 0x77, 0xFF, 0xDD, 0xFF },
+        { 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0xFF, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 },
+        { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 },
+        { 0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81 },
+    } };
+
+    static constexpr float kappa = 0.5522847498f;
+
+    std::uint32_t pack( std::uint32_t r, std::uint32_t g, std::uint32_t b, std::uint32_t a )
+    {
+        return r | ( g << 8 ) | ( b << 16 ) | ( a << 24 );
+    }
+    std::uint32_t premultiply( std::uint32_t c )
+    {
+        std::uint32_t a = c >> 24;
+        std::uint32_t r = ( ( c & 0xFF ) * a + 127 ) / 255;
+        std::uint32_t g = ( ( ( c >> 8 ) & 0xFF ) * a + 127 ) / 255;
+        std::uint32_t b = ( ( ( c >> 16 ) & 0xFF ) * a + 127 ) / 255;
+        return pack( r, g, b, a );
+    }
+    std::uint32_t premultiply( const xui::color & c )
+    {
+        return premultiply( pack( c.r, c.g, c.b, c.a ) );
+    }
+    std::uint32_t mul( std::uint32_t c, std::uint32_t a )
+    {
+        std::uint32_t rb = ( c & 0x00FF00FF ) * a + 0x00800080;
+        rb = ( ( rb + ( ( rb >> 8 ) & 0x00FF00FF ) ) >> 8 ) & 0x00FF00FF;
+        std::uint32_t ag = ( ( c >> 8 ) & 0x00FF00FF ) * a + 0x00800080;
+        ag = ( ag + ( ( ag >> 8 ) & 0x00FF00FF ) ) & 0xFF00FF00;
+        return rb | ag;
+    }
+    std::uint32_t blend( std::uint32_t dst, std::uint32_t src, std::uint32_t coverage )
+    {
+        if ( coverage != 255 )
+            src = mul( src, coverage );
+
+        return src + mul( dst, 255 - ( src >> 24 ) );
+    }
+    std::uint32_t lerp( std::uint32_t c1, std::uint32_t c2, std::uint32_t t )
+    {
+        return mul( c1, 255 - t ) + mul( c2, t );
+    }
+
+    struct span_kernels
+    {
+        void ( *accumulate )( const float * cells, std::uint8_t * coverage, int count );
+        void ( *blend_color )( std::uint32_t * dst, std::uint32_t color, const std::uint8_t * coverage, int count );
+        void ( *blend_pixels )( std::uint32_t * dst, const std::uint32_t * src, const std::uint8_t * coverage, int count );
+    };
+
+    void accumulate_tail( const float * cells, std::uint8_t * coverage, int count, float acc )
+    {
+        for ( int i = 0; i < count; i++ )
+        {
+            acc += cells[i];
+            coverage[i] = (std::uint8_t)std::min( 255.0f, std::abs( acc ) * 255.0f + 0.5f );
+        }
+    }
+#ifndef XUI_SOFTWARE_X64
+    void accumulate_scalar( const float * cells, std::uint8_t * coverage, int count )
+    {
+        // groups of 4 are summed in the order of the sse2 prefix sum so both round the same way
+        int i = 0;
+        float acc = 0;
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            const float * c = cells + i;
+            float s01 = c[0] + c[1];
+            float sum[4] = { c[0] + acc, s01 + acc, ( ( c[1] + c[2] ) + c[0] ) + acc, ( ( c[2] + c[3] ) + s01 ) + acc };
+
+            for ( int j = 0; j < 4; j++ )
+                coverage[i + j] = (std::uint8_t)std::min( 255.0f, std::abs( sum[j] ) * 255.0f + 0.5f );
+            acc = sum[3];
+        }
+
+        accumulate_tail( cells + i, coverage + i, count - i, acc );
+    }
+#endif
+    void blend_color_scalar( std::uint32_t * dst, std::uint32_t color, const std::uint8_t * coverage, int count )
+    {
+        for ( int i = 0; i < count; i++ )
+            dst[i] = blend( dst[i], color, coverage[i] );
+    }
+    void blend_pixels_scalar( std::uint32_t * dst, const std::uint32_t * src, const std::uint8_t * coverage, int count )
+    {
+        for ( int i = 0; i < count; i++ )
+            dst[i] = blend( dst[i], src[i], coverage[i] );
+    }
+
+#ifdef XUI_SOFTWARE_X64
+    // same rounding as mul(): ( x + 128 + ( ( x + 128 ) >> 8 ) ) >> 8, with the matching prefix sum order every kernel yields identical pixels
+    inline __m128i div255_sse2( __m128i x )
+    {
+        x = _mm_add_epi16( x, _mm_set1_epi16( 128 ) );
+        return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+    }
+    inline __m128i expand_sse2( const std::uint8_t * coverage )
+    {
+        int bits;
+        std::memcpy( &bits, coverage, 4 );
+        __m128i c = _mm_cvtsi32_si128( bits );
+        c = _mm_unpacklo_epi8( c, c );
+        return _mm_unpacklo_epi16( c, c );
+    }
+    inline __m128i blend_sse2( __m128i dst, __m128i src, __m128i cov )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16( 255 );
+
+        __m128i s_lo = div255_sse2( _mm_mullo_epi16( _mm_unpacklo_epi8( src, zero ), _mm_unpacklo_epi8( cov, zero ) ) );
+        __m128i s_hi = div255_sse2( _mm_mullo_epi16( _mm_unpackhi_epi8( src, zero ), _mm_unpackhi_epi8( cov, zero ) ) );
+        __m128i a_lo = _mm_sub_epi16( full, _mm_shufflehi_epi16( _mm_shufflelo_epi16( s_lo, 0xFF ), 0xFF ) );
+        __m128i a_hi = _mm_sub_epi16( full, _mm_shufflehi_epi16( _mm_shufflelo_epi16( s_hi, 0xFF ), 0xFF ) );
+        __m128i d_lo = div255_sse2( _mm_mullo_epi16( _mm_unpacklo_epi8( dst, zero ), a_lo ) );
+        __m128i d_hi = div255_sse2( _mm_mullo_epi16( _mm_unpackhi_epi8( dst, zero ), a_hi ) );
+
+        return _mm_packus_epi16( _mm_add_epi16( s_lo, d_lo ), _mm_add_epi16( s_hi, d_hi ) );
+    }
+    void accumulate_sse2( const float * cells, std::uint8_t * coverage, int count )
+    {
+        const __m128 sign = _mm_set1_ps( -0.0f );
+        const __m128 half = _mm_set1_ps( 0.5f );
+        const __m128 scale = _mm_set1_ps( 255.0f );
+
+        int i = 0;
+        __m128 carry = _mm_setzero_ps();
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            __m128 x = _mm_loadu_ps( cells + i );
+            x = _mm_add_ps( x, _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128( x ), 4 ) ) );
+            x = _mm_add_ps( x, _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128( x ), 8 ) ) );
+            x = _mm_add_ps( x, carry );
+            carry = _mm_shuffle_ps( x, x, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+            __m128i v = _mm_cvttps_epi32( _mm_min_ps( _mm_add_ps( _mm_mul_ps( _mm_andnot_ps( sign, x ), scale ), half ), scale ) );
+            v = _mm_packs_epi32( v, v );
+            v = _mm_packus_epi16( v, v );
+
+            int bits = _mm_cvtsi128_si32( v );
+            std::memcpy( coverage + i, &bits, 4 );
+        }
+
+        accumulate_tail( cells + i, coverage + i, count - i, _mm_cvtss_f32( carry ) );
+    }
+    void blend_color_sse2( std::uint32_t * dst, std::uint32_t color, const std::uint8_t * coverage, int count )
+    {
+        const bool opaque = ( color >> 24 ) == 255;
+        const __m128i src = _mm_set1_epi32( (int)color );
+
+        int i = 0;
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            std::uint32_t bits;
+            std::memcpy( &bits, coverage + i, 4 );
+
+            auto * p = reinterpret_cast<__m128i *>( dst + i );
+            if ( opaque && bits == 0xFFFFFFFF )
+                _mm_storeu_si128( p, src );
+            else if ( bits != 0 )
+                _mm_storeu_si128( p, blend_sse2( _mm_loadu_si128( p ), src, expand_sse2( coverage + i ) ) );
+        }
+
+        blend_color_scalar( dst + i, color, coverage + i, count - i );
+    }
+    void blend_pixels_sse2( std::uint32_t * dst, const std::uint32_t * src, const std::uint8_t * coverage, int count )
+    {
+        int i = 0;
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            auto * p = reinterpret_cast<__m128i *>( dst + i );
+            _mm_storeu_si128( p, blend_sse2( _mm_loadu_si128( p ), _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i ) ), expand_sse2( coverage + i ) ) );
+        }
+
+        blend_pixels_scalar( dst + i, src + i, coverage + i, count - i );
+    }
+
+    XUI_TARGET_AVX2 inline __m256i div255_avx2( __m256i x )
+    {
+        x = _mm256_add_epi16( x, _mm256_set1_epi16( 128 ) );
+        return _mm256_srli_epi16( _mm256_add_epi16( x, _mm256_srli_epi16( x, 8 ) ), 8 );
+    }
+    XUI_TARGET_AVX2 inline __m256i expand_avx2( const std::uint8_t * coverage )
+    {
+        __m256i c = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( coverage ) ) );
+        return _mm256_mullo_epi32( c, _mm256_set1_epi32( 0x01010101 ) );
+    }
+    XUI_TARGET_AVX2 inline __m256i blend_avx2( __m256i dst, __m256i src, __m256i cov )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i full = _mm256_set1_epi16( 255 );
+
+        __m256i s_lo = div255_avx2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( src, zero ), _mm256_unpacklo_epi8( cov, zero ) ) );
+        __m256i s_hi = div255_avx2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( src, zero ), _mm256_unpackhi_epi8( cov, zero ) ) );
+        __m256i a_lo = _mm256_sub_epi16( full, _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( s_lo, 0xFF ), 0xFF ) );
+        __m256i a_hi = _mm256_sub_epi16( full, _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( s_hi, 0xFF ), 0xFF ) );
+        __m256i d_lo = div255_avx2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( dst, zero ), a_lo ) );
+        __m256i d_hi = div255_avx2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( dst, zero ), a_hi ) );
+
+        return _mm256_packus_epi16( _mm256_add_epi16( s_lo, d_lo ), _mm256_add_epi16( s_hi, d_hi ) );
+    }
+    XUI_TARGET_AVX2 void blend_color_avx2( std::uint32_t * dst, std::uint32_t color, const std::uint8_t * coverage, int count )
+    {
+        const bool opaque = ( color >> 24 ) == 255;
+        const __m256i src = _mm256_set1_epi32( (int)color );
+
+        int i = 0;
+        for ( ; i + 8 <= count; i += 8 )
+        {
+            std::uint64_t bits;
+            std::memcpy( &bits, coverage + i, 8 );
+
+            auto * p = reinterpret_cast<__m256i *>( dst + i );
+            if ( opaque && bits == 0xFFFFFFFFFFFFFFFFull )
+                _mm256_storeu_si256( p, src );
+            else if ( bits != 0 )
+                _mm256_storeu_si256( p, blend_avx2( _mm256_loadu_si256( p ), src, expand_avx2( coverage + i ) ) );
+        }
+
+        blend_color_sse2( dst + i, color, coverage + i, count - i );
+    }
+    XUI_TARGET_AVX2 void blend_pixels_avx2( std::uint32_t * dst, const std::uint32_t * src, const std::uint8_t * coverage, int count )
+    {
+        int i = 0;
+        for ( ; i + 8 <= count; i += 8 )
+        {
+            auto * p = reinterpret_cast<__m256i *>( dst + i );
+            _mm256_storeu_si256( p, blend_avx2( _mm256_loadu_si256( p ), _mm256_loadu_si256( reinterpret_cast<const __m256i *>( src + i ) ), expand_avx2( coverage + i ) ) );
+        }
+
+        blend_pixels_sse2( dst + i, src + i, coverage + i, count - i );
+    }
+
+    bool has_avx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid( info, 1 );
+        if ( ( info[2] & ( 1 << 27 ) ) == 0 || ( _xgetbv( 0 ) & 6 ) != 6 )
+            return false;
+
+        __cpuidex( info, 7, 0 );
+        return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+        return __builtin_cpu_supports( "avx2" );
+#endif
+    }
+#endif
+
+    const span_kernels & kernels()
+    {
+        static const span_kernels result = []() -> span_kernels
+        {
+#ifdef XUI_SOFTWARE_X64
+            if ( has_avx2() )
+                return { accumulate_sse2, blend_color_avx2, blend_pixels_avx2 };
+
+            return { accumulate_sse2, blend_color_sse2, blend_pixels_sse2 };
+#else
+            return { accumulate_scalar, blend_color_scalar, blend_pixels_scalar };
+#endif
+        }();
+
+        return result;
+    }
+
+    std::string utf8_encode( std::u32string_view str )
+    {
+        std::string result;
+        for ( auto c : str )
+        {
+            if ( c < 0x80 )
+            {
+                result.push_back( char( c ) );
+            }
+            else if ( c < 0x800 )
+            {
+                result.push_back( char( 0xC0 | ( c >> 6 ) ) );
+                result.push_back( char( 0x80 | ( c & 0x3F ) ) );
+            }
+            else if ( c < 0x10000 )
+            {
+                result.push_back( char( 0xE0 | ( c >> 12 ) ) );
+                result.push_back( char( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+                result.push_back( char( 0x80 | ( c & 0x3F ) ) );
+            }
+            else
+            {
+                result.push_back( char( 0xF0 | ( c >> 18 ) ) );
+                result.push_back( char( 0x80 | ( ( c >> 12 ) & 0x3F ) ) );
+                result.push_back( char( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+                result.push_back( char( 0x80 | ( c & 0x3F ) ) );
+            }
+        }
+        return result;
+    }
+    std::u32string utf8_decode( std::string_view str )
+    {
+        std::u32string result;
+        for ( std::size_t i = 0; i < str.size(); )
+        {
+            std::uint8_t c = str[i];
+            std::size_t len = c < 0x80 ? 1 : ( c >> 5 ) == 0x6 ? 2 : ( c >> 4 ) == 0xE ? 3 : ( c >> 3 ) == 0x1E ? 4 : 0;
+            if ( len == 0 || i + len > str.size() )
+            {
+                result.push_back( 0xFFFD );
+                ++i;
+                continue;
+            }
+
+            char32_t cp = len == 1 ? c : c & ( 0x7F >> len );
+            for ( std::size_t j = 1; j < len; j++ )
+                cp = ( cp << 6 ) | ( std::uint8_t( str[i + j] ) & 0x3F );
+
+            result.push_back( cp );
+            i += len;
+        }
+        return result;
+    }
+
+    struct box
+    {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        bool empty() const
+        {
+            return x0 >= x1 || y0 >= y1;
+        }
+        box intersected( const box & other ) const
+        {
+            return { std::max( x0, other.x0 ), std::max( y0, other.y0 ), std::min( x1, other.x1 ), std::min( y1, other.y1 ) };
+        }
+        box united( const box & other ) const
+        {
+            return { std::min( x0, other.x0 ), std::min( y0, other.y0 ), std::max( x1, other.x1 ), std::max( y1, other.y1 ) };
+        }
+        static box from( const xui::rect & rect )
+        {
+            return { (int)std::floor( rect.x ), (int)std::floor( rect.y ), (int)std::ceil( rect.x + rect.w ), (int)std::ceil( rect.y + rect.h ) };
+        }
+    };
+
+    struct contour
+    {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        bool closed = false;
+    };
+
+    class outline
+    {
+    public:
+        void clear()
+        {
+            _current = {};
+            _points.clear();
+            _contours.clear();
+        }
+        void move_to( const xui::vec2 & p )
+        {
+            finish( false );
+            _points.push_back( p );
+            _current = p;
+        }
+        void line_to( const xui::vec2 & p )
+        {
+            if ( !_contours.empty() && _contours.back().end == _points.size() )
+                move_to( _current );
+
+            _points.push_back( p );
+            _current = p;
+        }
+        void quad_to( const xui::vec2 & c, const xui::vec2 & p )
+        {
+            auto p0 = _current;
+            float dx = p0.x - 2 * c.x + p.x, dy = p0.y - 2 * c.y + p.y;
+            int n = std::min( 64, 1 + (int)std::sqrt( std::sqrt( 3.0f * ( dx * dx + dy * dy ) ) ) );
+
+            for ( int i = 1; i <= n; i++ )
+            {
+                float t = float( i ) / n, mt = 1 - t;
+                line_to( { mt * mt * p0.x + 2 * mt * t * c.x + t * t * p.x, mt * mt * p0.y + 2 * mt * t * c.y + t * t * p.y } );
+            }
+        }
+        void cubic_to( const xui::vec2 & c1, const xui::vec2 & c2, const xui::vec2 & p )
+        {
+            auto p0 = _current;
+            float dx1 = p0.x - 2 * c1.x + c2.x, dy1 = p0.y - 2 * c1.y + c2.y;
+            float dx2 = c1.x - 2 * c2.x + p.x, dy2 = c1.y - 2 * c2.y + p.y;
+            float dd = std::max( dx1 * dx1 + dy1 * dy1, dx2 * dx2 + dy2 * dy2 );
+            int n = std::min( 64, 1 + (int)std::sqrt( std::sqrt( 6.0f * dd ) ) );
+
+            for ( int i = 1; i <= n; i++ )
+            {
+                float t = float( i ) / n, mt = 1 - t;
+                float a = mt * mt * mt, b = 3 * mt * mt * t, c = 3 * mt * t * t, d = t * t * t;
+                line_to( { a * p0.x + b * c1.x + c * c2.x + d * p.x, a * p0.y + b * c1.y + c * c2.y + d * p.y } );
+            }
+        }
+        void close()
+        {
+            finish( true );
+        }
+
+    public:
+        void rect( const xui::rect & rect, const xui::vec4 & radius )
+        {
+            float limit = std::max( 0.0f, std::min( rect.w, rect.h ) / 2 );
+            float tl = std::clamp( radius.x, 0.0f, limit ), tr = std::clamp( radius.y, 0.0f, limit );
+            float br = std::clamp( radius.z, 0.0f, limit ), bl = std::clamp( radius.w, 0.0f, limit );
+            float x0 = rect.x, y0 = rect.y, x1 = rect.x + rect.w, y1 = rect.y + rect.h;
+
+            move_to( { x0 + tl, y0 } );
+            line_to( { x1 - tr, y0 } );
+            if ( tr > 0 ) cubic_to( { x1 - tr + tr * kappa, y0 }, { x1, y0 + tr - tr * kappa }, { x1, y0 + tr } );
+            line_to( { x1, y1 - br } );
+            if ( br > 0 ) cubic_to( { x1, y1 - br + br * kappa }, { x1 - br + br * kappa, y1 }, { x1 - br, y1 } );
+            line_to( { x0 + bl, y1 } );
+            if ( bl > 0 ) cubic_to( { x0 + bl - bl * kappa, y1 }, { x0, y1 - bl + bl * kappa }, { x0, y1 - bl } );
+            line_to( { x0, y0 + tl } );
+            if ( tl > 0 ) cubic_to( { x0, y0 + tl - tl * kappa }, { x0 + tl - tl * kappa, y0 }, { x0 + tl, y0 } );
+            close();
+        }
+        void ellipse( const xui::vec2 & center, const xui::vec2 & radius )
+        {
+            float kx = radius.x * kappa, ky = radius.y * kappa;
+            float x0 = center.x - radius.x, x1 = center.x + radius.x;
+            float y0 = center.y - radius.y, y1 = center.y + radius.y;
+
+            move_to( { x1, center.y } );
+            cubic_to( { x1, center.y + ky }, { center.x + kx, y1 }, { center.x, y1 } );
+            cubic_to( { center.x - kx, y1 }, { x0, center.y + ky }, { x0, center.y } );
+            cubic_to( { x0, center.y - ky }, { center.x - kx, y0 }, { center.x, y0 } );
+            cubic_to( { center.x + kx, y0 }, { x1, center.y - ky }, { x1, center.y } );
+            close();
+        }
+        void polygon( std::span<const xui::vec2> points )
+        {
+            if ( points.empty() )
+                return;
+
+            move_to( points[0] );
+            for ( std::size_t i = 1; i < points.size(); i++ )
+                line_to( points[i] );
+            close();
+        }
+
+    public:
+        bool empty() const
+        {
+            return _points.empty();
+        }
+        std::span<const xui::vec2> points( const contour & c ) const
+        {
+            return { _points.data() + c.begin, c.end - c.begin };
+        }
+        std::span<const contour> contours()
+        {
+            finish( false );
+            return _contours;
+        }
+
+    private:
+        void finish( bool closed )
+        {
+            std::size_t begin = _contours.empty() ? 0 : _contours.back().end;
+            if ( begin == _points.size() )
+                return;
+
+            _contours.push_back( { begin, _points.size(), closed } );
+            if ( closed )
+                _current = _points[begin];
+        }
+
+    private:
+        xui::vec2 _current;
+        std::vector<xui::vec2> _points;
+        std::vector<contour> _contours;
+    };
+
+    // coverage accumulation rasterizer, see font-rs
+    class rasterizer
+    {
+    private:
+        struct segment
+        {
+            xui::vec2 p0, p1;
+        };
+
+    public:
+        void clear()
+        {
+            _segments.clear();
+        }
+        void line( const xui::vec2 & p0, const xui::vec2 & p1 )
+        {
+            if ( p0.y != p1.y && std::isfinite( p0.x + p0.y + p1.x + p1.y ) )
+                _segments.push_back( { p0, p1 } );
+        }
+        void polygon( std::span<const xui::vec2> points )
+        {
+            for ( std::size_t i = 0; i < points.size(); i++ )
+                line( points[i], points[( i + 1 ) % points.size()] );
+        }
+        void fill( outline & src )
+        {
+            for ( const auto & c : src.contours() )
+                polygon( src.points( c ) );
+        }
+        template<typename F> void rasterize( const box & clip, F && span )
+        {
+            if ( _segments.empty() )
+                return;
+
+            float minx = std::numeric_limits<float>::max(), miny = minx;
+            float maxx = std::numeric_limits<float>::lowest(), maxy = maxx;
+            for ( const auto & it : _segments )
+            {
+                minx = std::min( { minx, it.p0.x, it.p1.x } );
+                miny = std::min( { miny, it.p0.y, it.p1.y } );
+                maxx = std::max( { maxx, it.p0.x, it.p1.x } );
+                maxy = std::max( { maxy, it.p0.y, it.p1.y } );
+            }
+
+            box area = clip.intersected( { (int)std::floor( minx ), (int)std::floor( miny ), (int)std::ceil( maxx ), (int)std::ceil( maxy ) } );
+            if ( area.empty() )
+            {
+                _segments.clear();
+                return;
+            }
+
+            // cells are zeroed again as they are accumulated, only growth needs clearing
+            int w = area.x1 - area.x0, h = area.y1 - area.y0;
+            if ( _cells.size() < std::size_t( w + 2 ) * h )
+                _cells.resize( std::size_t( w + 2 ) * h, 0.0f );
+            _coverage.resize( w );
+            _extents.assign( h, { w + 2, -1 } );
+
+            xui::vec2 offset = { float( area.x0 ), float( area.y0 ) };
+            for ( const auto & it : _segments )
+                clip_line( it.p0 - offset, it.p1 - offset, w, h );
+
+            for ( int y = 0; y < h; y++ )
+            {
+                auto [lo, hi] = _extents[y];
+                if ( hi < lo || lo >= w )
+                {
+                    if ( hi >= lo )
+                        std::fill( _cells.data() + std::size_t( y ) * ( w + 2 ) + lo, _cells.data() + std::size_t( y ) * ( w + 2 ) + hi + 1, 0.0f );
+                    continue;
+                }
+
+                // past the last touched cell the sum stays constant, so it is filled instead of accumulated
+                float * row = _cells.data() + std::size_t( y ) * ( w + 2 );
+                int last = std::min( hi + 1, w );
+                kernels().accumulate( row + lo, _coverage.data() + lo, last - lo );
+                std::fill( _coverage.data() + last, _coverage.data() + w, _coverage[last - 1] );
+                std::fill( row + lo, row + hi + 1, 0.0f );
+
+                int beg = lo, end = w;
+                while ( beg < end && _coverage[beg] == 0 ) ++beg;
+                while ( end > beg && _coverage[end - 1] == 0 ) --end;
+
+                if ( beg < end )
+                    span( area.y0 + y, area.x0 + beg, end - beg, _coverage.data() + beg );
+            }
+
+            _segments.clear();
+        }
+
+    private:
+        void clip_line( const xui::vec2 & p0, const xui::vec2 & p1, int w, int h )
+        {
+            // segments above, below or right of the area add nothing, left of it they still add up in the first cell
+            if ( std::max( p0.y, p1.y ) <= 0 || std::min( p0.y, p1.y ) >= float( h ) || std::min( p0.x, p1.x ) >= float( w ) )
+                return;
+
+            float ts[4] = { 0 };
+            int n = 1;
+            for ( float edge : { 0.0f, float( w ) } )
+            {
+                if ( ( p0.x - edge ) * ( p1.x - edge ) < 0 )
+                    ts[n++] = ( edge - p0.x ) / ( p1.x - p0.x );
+            }
+            ts[n++] = 1;
+            std::sort( ts, ts + n );
+
+            for ( int i = 0; i + 1 < n; i++ )
+            {
+                xui::vec2 a = p0 + ( p1 - p0 ) * ts[i];
+                xui::vec2 b = p0 + ( p1 - p0 ) * ts[i + 1];
+                a.x = std::clamp( a.x, 0.0f, float( w ) );
+                b.x = std::clamp( b.x, 0.0f, float( w ) );
+                draw_line( a, b, w, h );
+            }
+        }
+        void draw_line( xui::vec2 p0, xui::vec2 p1, int w, int h )
+        {
+            if ( p0.y == p1.y )
+                return;
+
+            float dir = 1;
+            if ( p0.y > p1.y )
+            {
+                std::swap( p0, p1 );
+                dir = -1;
+            }
+
+            float dxdy = ( p1.x - p0.x ) / ( p1.y - p0.y );
+            float x = p0.x;
+            if ( p0.y < 0 )
+                x -= p0.y * dxdy;
+
+            int y0 = std::max( 0, (int)std::floor( p0.y ) );
+            int y1 = std::min( h, (int)std::ceil( p1.y ) );
+            for ( int y = y0; y < y1; y++ )
+            {
+                float * row = _cells.data() + std::size_t( y ) * ( w + 2 );
+                float dy = std::min( float( y + 1 ), p1.y ) - std::max( float( y ), p0.y );
+                float xnext = std::clamp( x + dxdy * dy, 0.0f, float( w ) );
+                float d = dy * dir;
+
+                float xa = std::min( x, xnext ), xb = std::max( x, xnext );
+                float xa_floor = std::floor( xa ), xb_ceil = std::ceil( xb );
+                int xai = (int)xa_floor, xbi = (int)xb_ceil;
+
+                auto & extent = _extents[y];
+                extent.first = std::min( extent.first, xai );
+                extent.second = std::max( extent.second, std::max( xbi, xai + 1 ) );
+
+                if ( xbi <= xai + 1 )
+                {
+                    float xmf = 0.5f * ( x + xnext ) - xa_floor;
+                    row[xai] += d - d * xmf;
+                    row[xai + 1] += d * xmf;
+                }
+                else
+                {
+                    float s = 1.0f / ( xb - xa );
+                    float xaf = xa - xa_floor;
+                    float a0 = 0.5f * s * ( 1 - xaf ) * ( 1 - xaf );
+                    float xbf = xb - xb_ceil + 1;
+                    float am = 0.5f * s * xbf * xbf;
+
+                    row[xai] += d * a0;
+                    if ( xbi == xai + 2 )
+                    {
+                        row[xai + 1] += d * ( 1 - a0 - am );
+                    }
+                    else
+                    {
+                        float a1 = s * ( 1.5f - xaf );
+                        row[xai + 1] += d * ( a1 - a0 );
+                        for ( int xi = xai + 2; xi < xbi - 1; xi++ )
+                            row[xi] += d * s;
+                        float a2 = a1 + ( xbi - xai - 3 ) * s;
+                        row[xbi - 1] += d * ( 1 - a2 - am );
+                    }
+                    row[xbi] += d * am;
+                }
+
+                x = xnext;
+            }
+        }
+
+    private:
+        std::vector<float> _cells;
+        std::vector<segment> _segments;
+        std::vector<std::uint8_t> _coverage;
+        std::vector<std::pair<int, int>> _extents;
+    };
+
+    class stroker
+    {
+    public:
+        static void stroke( rasterizer & r, outline & src, const xui::stroke & stroke )
+        {
+            float hw = stroke.width / 2;
+            if ( hw <= 0 )
+                return;
+
+            std::span<const float> pattern;
+            static constexpr float dash[] = { 3, 1 };
+            static constexpr float dot[] = { 1, 1 };
+            static constexpr float dash_dot[] = { 3, 1, 1, 1 };
+            static constexpr float dash_dot_dot[] = { 3, 1, 1, 1, 1, 1 };
+            switch ( stroke.style )
+            {
+            case xui::stroke::DASHED: pattern = dash; break;
+            case xui::stroke::DOTTED: pattern = dot; break;
+            case xui::stroke::DASH_DOT: pattern = dash_dot; break;
+            case xui::stroke::DASH_DOT_DOT: pattern = dash_dot_dot; break;
+            default: break;
+            }
+
+            std::vector<xui::vec2> points;
+            for ( const auto & c : src.contours() )
+            {
+                auto pts = src.points( c );
+                points.assign( pts.begin(), pts.end() );
+                if ( c.closed && points.size() > 2 )
+                    points.push_back( points.front() );
+
+                if ( pattern.empty() )
+                    polyline( r, points, hw, c.closed );
+                else
+                    dashes( r, points, hw, pattern, stroke.width );
+            }
+        }
+
+    private:
+        static void dashes( rasterizer & r, std::span<const xui::vec2> points, float hw, std::span<const float> pattern, float unit )
+        {
+            std::vector<xui::vec2> dash;
+            std::size_t idx = 0;
+            float remain = pattern[0] * unit;
+            bool on = true;
+
+            if ( on && !points.empty() )
+                dash.push_back( points[0] );
+
+            for ( std::size_t i = 0; i + 1 < points.size(); i++ )
+            {
+                xui::vec2 a = points[i], b = points[i + 1];
+                float len = length( b - a ), pos = 0;
+
+                while ( len - pos > remain )
+                {
+                    pos += remain;
+                    xui::vec2 p = a + ( b - a ) * ( pos / len );
+                    if ( on )
+                    {
+                        dash.push_back( p );
+                        polyline( r, dash, hw, false );
+                        dash.clear();
+                    }
+                    else
+                    {
+                        dash.push_back( p );
+                    }
+
+                    on = !on;
+                    idx = ( idx + 1 ) % pattern.size();
+                    remain = pattern[idx] * unit;
+                }
+
+                remain -= len - pos;
+                if ( on )
+                    dash.push_back( b );
+            }
+
+            if ( on )
+                polyline( r, dash, hw, false );
+        }
+        static void polyline( rasterizer & r, std::span<const xui::vec2> points, float hw, bool closed )
+        {
+            if ( points.size() < 2 )
+                return;
+
+            xui::vec2 n0 = {}, u0 = {};
+            xui::vec2 first_n = {}, first_u = {};
+            bool has_prev = false;
+
+            for ( std::size_t i = 0; i + 1 < points.size(); i++ )
+            {
+                xui::vec2 a = points[i], b = points[i + 1];
+                xui::vec2 d = b - a;
+                float len = length( d );
+                if ( len <= std::numeric_limits<float>::epsilon() )
+                    continue;
+
+                xui::vec2 u = d / len;
+                xui::vec2 n = { -u.y * hw, u.x * hw };
+
+                xui::vec2 quad[4] = { a + n, b + n, b - n, a - n };
+                polygon( r, quad );
+
+                if ( has_prev )
+                    join( r, a, u0, n0, u, n );
+                else
+                    first_n = n, first_u = u;
+
+                has_prev = true;
+                n0 = n;
+                u0 = u;
+            }
+
+            if ( closed && has_prev )
+                join( r, points.back(), u0, n0, first_u, first_n );
+        }
+        static void join( rasterizer & r, const xui::vec2 & p, const xui::vec2 & u0, const xui::vec2 & n0, const xui::vec2 & u1, const xui::vec2 & n1 )
+        {
+            float cos = u0.x * u1.x + u0.y * u1.y;
+            if ( cos > 0.9999f )
+                return;
+
+            // gdi+ default miter limit is 10
+            if ( 1 + cos > 2.0f / 100.0f )
+            {
+                xui::vec2 m = ( n0 + n1 ) / ( 1 + cos );
+                xui::vec2 outer[4] = { p, p + n0, p + m, p + n1 };
+                xui::vec2 inner[4] = { p, p - n0, p - m, p - n1 };
+                polygon( r, outer );
+                polygon( r, inner );
+            }
+            else
+            {
+                xui::vec2 outer[3] = { p, p + n0, p + n1 };
+                xui::vec2 inner[3] = { p, p - n0, p - n1 };
+                polygon( r, outer );
+                polygon( r, inner );
+            }
+        }
+        static void polygon( rasterizer & r, std::span<xui::vec2> points )
+        {
+            // every stroke piece is wound the same way so overlaps add up instead of cancelling
+            float area = 0;
+            for ( std::size_t i = 0; i < points.size(); i++ )
+            {
+                const auto & a = points[i], & b = points[( i + 1 ) % points.size()];
+                area += a.x * b.y - b.x * a.y;
+            }
+            if ( area > 0 )
+                std::reverse( points.begin(), points.end() );
+
+            r.polygon( points );
+        }
+        static float length( const xui::vec2 & v )
+        {
+            return std::sqrt( v.x * v.x + v.y * v.y );
+        }
+    };
+
+    struct texture
+    {
+        std::string name;
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint32_t> pixels;
+    };
+
+    class paint
+    {
+    public:
+        enum kind
+        {
+            NONE,
+            SOLID,
+            HATCH,
+            GRADIENT,
+            TEXTURE,
+            IMAGE,
+        };
+
+    public:
+        paint() = default;
+        paint( const xui::color & color )
+        {
+            set_color( premultiply( color ) );
+        }
+        paint( const xui::filled & filled, std::span<const texture> textures )
+        {
+            switch ( filled.colors.index() )
+            {
+            case 1:
+                set_color( premultiply( std::get<xui::color>( filled.colors ) ) );
+                break;
+            case 2:
+            {
+                const auto & hatch = std::get<xui::hatch_color>( filled.colors );
+                if ( filled.style >= xui::filled::DENSE1 && filled.style <= xui::filled::DIAGCROSS )
+                {
+                    _kind = HATCH;
+                    _mask = hatch_masks[filled.style - xui::filled::DENSE1].data();
+                    _c1 = premultiply( hatch.fore );
+                    _c2 = premultiply( hatch.back );
+                }
+                else
+                {
+                    set_color( premultiply( hatch.fore ) );
+                }
+            }
+                break;
+            case 3:
+            {
+                const auto & brush = std::get<xui::texture_brush>( filled.colors );
+                auto it = std::find_if( textures.begin(), textures.end(), [&]( const auto & val ) { return val.name == brush.image; } );
+                if ( it != textures.end() && !it->pixels.empty() )
+                {
+                    _kind = TEXTURE;
+                    _texture = &*it;
+                    _mode = brush.mode;
+                }
+            }
+                break;
+            case 4:
+            {
+                const auto & gradient = std::get<xui::linear_gradient>( filled.colors );
+                _kind = GRADIENT;
+                _c1 = premultiply( gradient.c1 );
+                _c2 = premultiply( gradient.c2 );
+                _origin = gradient.p1;
+                _axis = gradient.p2 - gradient.p1;
+                float len = _axis.x * _axis.x + _axis.y * _axis.y;
+                _axis = len > 0 ? _axis / len : xui::vec2{};
+            }
+                break;
+            }
+        }
+        paint( const texture & tex, const xui::rect & rect )
+        {
+            if ( !tex.pixels.empty() && rect.w > 0 && rect.h > 0 )
+            {
+                _kind = IMAGE;
+                _texture = &tex;
+                _origin = { rect.x, rect.y };
+                _axis = { tex.width / rect.w, tex.height / rect.h };
+            }
+        }
+
+    public:
+        bool empty() const
+        {
+            return _kind == NONE || ( _kind == SOLID && ( _c1 >> 24 ) == 0 );
+        }
+        bool solid() const
+        {
+            return _kind == SOLID;
+        }
+        std::uint32_t color() const
+        {
+            return _c1;
+        }
+        void shade( int x, int y, int count, std::uint32_t * out ) const
+        {
+            switch ( _kind )
+            {
+            case SOLID:
+                std::fill( out, out + count, _c1 );
+                break;
+            case HATCH:
+            {
+                std::uint32_t pattern[8];
+                for ( int i = 0; i < 8; i++ )
+                    pattern[i] = ( ( _mask[y & 7] >> ( 7 - i ) ) & 1 ) ? _c1 : _c2;
+                for ( int i = 0; i < count; i++ )
+                    out[i] = pattern[( x + i ) & 7];
+            }
+                break;
+            case GRADIENT:
+            {
+                float py = y + 0.5f - _origin.y;
+                for ( int i = 0; i < count; i++ )
+                {
+                    float t = ( x + i + 0.5f - _origin.x ) * _axis.x + py * _axis.y;
+                    t -= std::floor( t );
+                    out[i] = lerp( _c1, _c2, std::uint32_t( t * 255.0f + 0.5f ) );
+                }
+            }
+                break;
+            case TEXTURE:
+            {
+                int w = _texture->width, h = _texture->height;
+                int ty = wrap( y, h, _mode == xui::texture_brush::WRAP_TILEFLIPY || _mode == xui::texture_brush::WRAP_TILEFLIPXY );
+                for ( int i = 0; i < count; i++ )
+                {
+                    int tx = wrap( x + i, w, _mode == xui::texture_brush::WRAP_TILEFLIPX || _mode == xui::texture_brush::WRAP_TILEFLIPXY );
+                    out[i] = ( tx < 0 || ty < 0 ) ? 0 : _texture->pixels[std::size_t( ty ) * w + tx];
+                }
+            }
+                break;
+            case IMAGE:
+            {
+                int w = _texture->width, h = _texture->height;
+                float v = ( y + 0.5f - _origin.y ) * _axis.y - 0.5f;
+                int y0 = (int)std::floor( v );
+                auto fy = std::uint32_t( ( v - y0 ) * 255.0f + 0.5f );
+                const auto * r0 = _texture->pixels.data() + std::size_t( std::clamp( y0, 0, h - 1 ) ) * w;
+                const auto * r1 = _texture->pixels.data() + std::size_t( std::clamp( y0 + 1, 0, h - 1 ) ) * w;
+                for ( int i = 0; i < count; i++ )
+                {
+                    float u = ( x + i + 0.5f - _origin.x ) * _axis.x - 0.5f;
+                    int x0 = (int)std::floor( u );
+                    auto fx = std::uint32_t( ( u - x0 ) * 255.0f + 0.5f );
+                    int xa = std::clamp( x0, 0, w - 1 ), xb = std::clamp( x0 + 1, 0, w - 1 );
+                    out[i] = lerp( lerp( r0[xa], r0[xb], fx ), lerp( r1[xa], r1[xb], fx ), fy );
+                }
+            }
+                break;
+            default:
+                std::fill( out, out + count, 0 );
+                break;
+            }
+        }
+
+    private:
+        void set_color( std::uint32_t color )
+        {
+            _kind = SOLID;
+            _c1 = color;
+        }
+        int wrap( int v, int size, bool flip ) const
+        {
+            if ( _mode == xui::texture_brush::WRAP_CLAMP )
+                return ( v < 0 || v >= size ) ? -1 : v;
+
+            int tile = (int)std::floor( float( v ) / size );
+            int r = v - tile * size;
+            return ( flip && ( tile & 1 ) ) ? size - 1 - r : r;
+        }
+
+    private:
+        kind _kind = NONE;
+        std::uint32_t _c1 = 0;
+        std::uint32_t _c2 = 0;
+        xui::vec2 _origin;
+        xui::vec2 _axis;
+        const std::uint8_t * _mask = nullptr;
+        const texture * _texture = nullptr;
+        xui::texture_brush::warp _mode = xui::texture_brush::WRAP_TILE;
+    };
+
+    class font_face
+    {
+    private:
+        struct glyph
+        {
+            std::vector<xui::vec2> points;
+            std::vector<bool> on_curve;
+            std::vector<std::size_t> ends;
+        };
+
+    public:
+        bool load( std::vector<std::uint8_t> && data )
+        {
+            _data = std::move( data );
+
+            if ( u32( 0 ) != 0x00010000 && u32( 0 ) != 0x74727565 )
+                return false;
+
+            std::uint32_t head = 0, hhea = 0, maxp = 0, cmap = 0, name = 0;
+            for ( std::uint32_t i = 0, n = u16( 4 ); i < n; i++ )
+            {
+                std::uint32_t rec = 12 + i * 16;
+                std::uint32_t tag = u32( rec ), offset = u32( rec + 8 );
+                switch ( tag )
+                {
+                case 0x68656164: head = offset; break;
+                case 0x68686561: hhea = offset; break;
+                case 0x6D617870: maxp = offset; break;
+                case 0x636D6170: cmap = offset; break;
+                case 0x6E616D65: name = offset; break;
+                case 0x686D7478: _hmtx = offset; break;
+                case 0x6C6F6361: _loca = offset; break;
+                case 0x676C7966: _glyf = offset; break;
+                }
+            }
+            if ( head == 0 || hhea == 0 || maxp == 0 || cmap == 0 || _hmtx == 0 || _loca == 0 || _glyf == 0 )
+                return false;
+
+            units_per_em = std::max<int>( 1, u16( head + 18 ) );
+            _long_loca = i16( head + 50 ) != 0;
+            ascender = i16( hhea + 4 );
+            descender = i16( hhea + 6 );
+            line_gap = i16( hhea + 8 );
+            _hmetrics = std::max<std::uint16_t>( 1, u16( hhea + 34 ) );
+            _glyphs = u16( maxp + 4 );
+
+            int best = 0;
+            for ( std::uint32_t i = 0, n = u16( cmap + 2 ); i < n; i++ )
+            {
+                std::uint32_t rec = cmap + 4 + i * 8;
+                std::uint16_t platform = u16( rec ), encoding = u16( rec + 2 );
+                std::uint32_t sub = cmap + u32( rec + 4 );
+                std::uint16_t format = u16( sub );
+
+                int score = 0;
+                if ( format == 12 && ( platform == 0 || ( platform == 3 && encoding == 10 ) ) ) score = 3;
+                else if ( format == 4 && platform == 3 && encoding == 1 ) score = 2;
+                else if ( format == 4 && platform == 0 ) score = 1;
+
+                if ( score > best )
+                {
+                    best = score;
+                    _cmap = sub;
+                }
+            }
+            if ( best == 0 )
+                return false;
+
+            if ( name != 0 )
+                family = read_family( name );
+
+            return true;
+        }
+        std::uint16_t glyph_index( char32_t cp ) const
+        {
+            if ( u16( _cmap ) == 12 )
+            {
+                for ( std::uint32_t i = 0, n = u32( _cmap + 12 ); i < n; i++ )
+                {
+                    std::uint32_t rec = _cmap + 16 + i * 12;
+                    if ( cp >= u32( rec ) && cp <= u32( rec + 4 ) )
+                        return std::uint16_t( u32( rec + 8 ) + ( cp - u32( rec ) ) );
+                }
+                return 0;
+            }
+
+            if ( cp > 0xFFFF )
+                return 0;
+
+            std::uint32_t segs = u16( _cmap + 6 );
+            std::uint32_t ends = _cmap + 14, starts = ends + segs + 2, deltas = starts + segs, ranges = deltas + segs;
+            for ( std::uint32_t i = 0; i < segs; i += 2 )
+            {
+                if ( cp > u16( ends + i ) )
+                    continue;
+                if ( cp < u16( starts + i ) )
+                    return 0;
+
+                std::uint16_t range = u16( ranges + i );
+                if ( range == 0 )
+                    return std::uint16_t( cp + u16( deltas + i ) );
+
+                std::uint16_t g = u16( ranges + i + range + 2 * ( cp - u16( starts + i ) ) );
+                return g == 0 ? 0 : std::uint16_t( g + u16( deltas + i ) );
+            }
+            return 0;
+        }
+        float advance( std::uint16_t g ) const
+        {
+            return u16( _hmtx + 4 * std::min<std::uint32_t>( g, _hmetrics - 1 ) );
+        }
+        void emit( std::uint16_t g, const xui::vec2 & origin, float scale, float skew, outline & out ) const
+        {
+            const auto & gl = find( g );
+
+            auto transform = [&]( const xui::vec2 & p ) -> xui::vec2
+            {
+                return { origin.x + ( p.x + p.y * skew ) * scale, origin.y - p.y * scale };
+            };
+
+            std::size_t begin = 0;
+            for ( auto end : gl.ends )
+            {
+                if ( end > begin )
+                {
+                    xui::vec2 start;
+                    std::size_t first = begin, last = end;
+                    if ( gl.on_curve[begin] )
+                        start = transform( gl.points[begin] ), first = begin + 1;
+                    else if ( gl.on_curve[end - 1] )
+                        start = transform( gl.points[end - 1] ), last = end - 1;
+                    else
+                        start = ( transform( gl.points[begin] ) + transform( gl.points[end - 1] ) ) / 2;
+
+                    out.move_to( start );
+
+                    bool has_ctrl = false;
+                    xui::vec2 ctrl;
+                    for ( std::size_t i = first; i < last; i++ )
+                    {
+                        auto p = transform( gl.points[i] );
+                        if ( gl.on_curve[i] )
+                        {
+                            if ( has_ctrl )
+                                out.quad_to( ctrl, p );
+                            else
+                                out.line_to( p );
+                            has_ctrl = false;
+                        }
+                        else
+                        {
+                            if ( has_ctrl )
+                                out.quad_to( ctrl, ( ctrl + p ) / 2 );
+                            ctrl = p;
+                            has_ctrl = true;
+                        }
+                    }
+                    if ( has_ctrl )
+                        out.quad_to( ctrl, start );
+
+                    out.close();
+                }
+                begin = end;
+            }
+        }
+
+    public:
+        std::string family;
+        int units_per_em = 1;
+        int ascender = 0;
+        int descender = 0;
+        int line_gap = 0;
+
+    private:
+        const glyph & find( std::uint16_t g ) const
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+
+            auto it = _cache.find( g );
+            if ( it == _cache.end() )
+            {
+                glyph gl;
+                parse( g, gl, 0 );
+                it = _cache.emplace( g, std::move( gl ) ).first;
+            }
+            return it->second;
+        }
+        void parse( std::uint16_t g, glyph & gl, int depth ) const
+        {
+            if ( g >= _glyphs || depth > 8 )
+                return;
+
+            std::uint32_t beg = _long_loca ? u32( _loca + g * 4 ) : u16( _loca + g * 2 ) * 2u;
+            std::uint32_t end = _long_loca ? u32( _loca + g * 4 + 4 ) : u16( _loca + g * 2 + 2 ) * 2u;
+            if ( end <= beg )
+                return;
+
+            std::uint32_t off = _glyf + beg;
+            std::int16_t contours = i16( off );
+            off += 10;
+
+            if ( contours >= 0 )
+            {
+                std::size_t base = gl.points.size();
+                std::vector<std::uint16_t> ends( contours );
+                for ( auto & it : ends )
+                    it = u16( off ), off += 2;
+
+                std::size_t count = contours ? ends.back() + 1u : 0;
+                off += 2 + u16( off );
+
+                std::vector<std::uint8_t> flags;
+                flags.reserve( count );
+                while ( flags.size() < count && off < _data.size() )
+                {
+                    std::uint8_t f = _data[off++];
+                    flags.push_back( f );
+                    if ( f & 8 )
+                    {
+                        for ( std::uint8_t r = off < _data.size() ? _data[off++] : 0; r > 0 && flags.size() < count; r-- )
+                            flags.push_back( f );
+                    }
+                }
+                flags.resize( count, 0 );
+
+                std::vector<xui::vec2> points( count );
+                int v = 0;
+                for ( std::size_t i = 0; i < count; i++ )
+                {
+                    if ( flags[i] & 2 ) v += ( flags[i] & 16 ) ? u8( off++ ) : -u8( off++ );
+                    else if ( !( flags[i] & 16 ) ) v += i16( off ), off += 2;
+                    points[i].x = float( v );
+                }
+                v = 0;
+                for ( std::size_t i = 0; i < count; i++ )
+                {
+                    if ( flags[i] & 4 ) v += ( flags[i] & 32 ) ? u8( off++ ) : -u8( off++ );
+                    else if ( !( flags[i] & 32 ) ) v += i16( off ), off += 2;
+                    points[i].y = float( v );
+                }
+
+                for ( std::size_t i = 0; i < count; i++ )
+                {
+                    gl.points.push_back( points[i] );
+                    gl.on_curve.push_back( flags[i] & 1 );
+                }
+                for ( auto it : ends )
+                    gl.ends.push_back( base + std::min<std::size_t>( it + 1u, count ) );
+            }
+            else
+            {
+                std::uint16_t flags = 0;
+                do
+                {
+                    flags = u16( off );
+                    std::uint16_t index = u16( off + 2 );
+                    off += 4;
+
+                    float dx = 0, dy = 0;
+                    if ( flags & 1 )
+                        dx = i16( off ), dy = i16( off + 2 ), off += 4;
+                    else
+                        dx = std::int8_t( u8( off ) ), dy = std::int8_t( u8( off + 1 ) ), off += 2;
+                    if ( !( flags & 2 ) )
+                        dx = dy = 0;
+
+                    float a = 1, b = 0, c = 0, d = 1;
+                    if ( flags & 8 )
+                        a = d = i16( off ) / 16384.0f, off += 2;
+                    else if ( flags & 0x40 )
+                        a = i16( off ) / 16384.0f, d = i16( off + 2 ) / 16384.0f, off += 4;
+                    else if ( flags & 0x80 )
+                        a = i16( off ) / 16384.0f, b = i16( off + 2 ) / 16384.0f, c = i16( off + 4 ) / 16384.0f, d = i16( off + 6 ) / 16384.0f, off += 8;
+
+                    glyph sub;
+                    parse( index, sub, depth + 1 );
+
+                    std::size_t base = gl.points.size();
+                    for ( std::size_t i = 0; i < sub.points.size(); i++ )
+                    {
+                        const auto & p = sub.points[i];
+                        gl.points.push_back( { p.x * a + p.y * c + dx, p.x * b + p.y * d + dy } );
+                        gl.on_curve.push_back( sub.on_curve[i] );
+                    }
+                    for ( auto it : sub.ends )
+                        gl.ends.push_back( base + it );
+
+                } while ( flags & 0x20 );
+            }
+        }
+        std::string read_family( std::uint32_t name ) const
+        {
+            std::string result;
+            std::uint32_t strings = name + u16( name + 4 );
+            for ( std::uint32_t i = 0, n = u16( name + 2 ); i < n; i++ )
+            {
+                std::uint32_t rec = name + 6 + i * 12;
+                if ( u16( rec + 6 ) != 1 )
+                    continue;
+
+                std::uint16_t platform = u16( rec );
+                std::uint32_t len = u16( rec + 8 ), off = strings + u16( rec + 10 );
+                if ( platform == 0 || platform == 3 )
+                {
+                    std::u32string str;
+                    for ( std::uint32_t j = 0; j + 1 < len; j += 2 )
+                        str.push_back( u16( off + j ) );
+                    return utf8_encode( str );
+                }
+                else if ( platform == 1 && result.empty() )
+                {
+                    for ( std::uint32_t j = 0; j < len; j++ )
+                        result.push_back( char( u8( off + j ) ) );
+                }
+            }
+            return result;
+        }
+
+    private:
+        std::uint8_t u8( std::uint32_t off ) const
+        {
+            return off < _data.size() ? _data[off] : 0;
+        }
+        std::uint16_t u16( std::uint32_t off ) const
+        {
+            return std::uint16_t( ( u8( off ) << 8 ) | u8( off + 1 ) );
+        }
+        std::int16_t i16( std::uint32_t off ) const
+        {
+            return std::int16_t( u16( off ) );
+        }
+        std::uint32_t u32( std::uint32_t off ) const
+        {
+            return ( std::uint32_t( u16( off ) ) << 16 ) | u16( off + 2 );
+        }
+
+    private:
+        bool _long_loca = false;
+        std::uint32_t _cmap = 0;
+        std::uint32_t _hmtx = 0;
+        std::uint32_t _loca = 0;
+        std::uint32_t _glyf = 0;
+        std::uint32_t _glyphs = 0;
+        std::uint32_t _hmetrics = 1;
+        std::vector<std::uint8_t> _data;
+        mutable std::mutex _mutex;
+        mutable std::unordered_map<std::uint16_t, glyph> _cache;
+    };
+
+    struct font
+    {
+        int size = 0;
+        bool valid = false;
+        xui::font_flag flag = xui::font_flag::FONT_NONE;
+        std::string family;
+        const font_face * face = nullptr;
+    };
+
+    struct eventmap
+    {
+    public:
+        xui::vec2 dt() const
+        {
+            return _cursorpos - _cursorold;
+        }
+        const xui::vec2 & pos() const
+        {
+            return _cursorpos;
+        }
+        const xui::vec2 & wheel() const
+        {
+            return _cursorwheel;
+        }
+        int operator[]( int idx ) const
+        {
+            return _events[idx];
+        }
+
+    public:
+        void flush()
+        {
+            _events[xui::event::KEY_MOUSE_LEFT_CLICK] = 0;
+            _events[xui::event::KEY_MOUSE_RIGHT_CLICK] = 0;
+            _events[xui::event::KEY_MOUSE_MIDDLE_CLICK] = 0;
+            _events[xui::event::KEY_MOUSE_LEFT_DBCLICK] = 0;
+            _events[xui::event::KEY_MOUSE_RIGHT_DBCLICK] = 0;
+            _events[xui::event::KEY_MOUSE_MIDDLE_DBCLICK] = 0;
+
+            _cursorold = _cursorpos;
+            _cursorwheel = {};
+            _unicodes.clear();
+        }
+
+    public:
+        xui::vec2 _cursorpos = {};
+        xui::vec2 _cursorold = {};
+        xui::vec2 _cursorwheel = {};
+        std::u32string _unicodes = {};
+        std::vector<xui::vec2> _touchs;
+        std::array<int, (size_t)xui::event::EVENT_MAX_COUNT> _events = { 0 };
+    };
+
+    struct window
+    {
+        bool valid = false;
+        bool invalid = true;
+        int width = 0;
+        int height = 0;
+        std::string title;
+        xui::rect rect;
+        xui::rect rrect;
+        xui::window_id parent = xui::invalid_window_id;
+        int status = xui::window_status::WINDOW_SHOW;
+        eventmap events;
+        std::vector<box> clips;
+        std::vector<std::size_t> tiles;
+        std::vector<xui::rect> damages;
+        std::vector<std::uint32_t> pixels;
+
+        void resize( const xui::rect & r )
+        {
+            rect = r;
+            width = std::max( 0, (int)std::ceil( r.w ) );
+            height = std::max( 0, (int)std::ceil( r.h ) );
+            pixels.assign( std::size_t( width ) * height, 0 );
+            invalid = true;
+        }
+    };
+
+    bool load_netpbm( std::string_view filename, texture & tex )
+    {
+        std::ifstream ifs( std::string( filename ), std::ios::binary );
+        if ( !ifs )
+            return false;
+
+        std::string magic;
+        ifs >> magic;
+
+        int width = 0, height = 0, depth = 3, maxval = 0;
+        if ( magic == "P6" )
+        {
+            auto next = [&]()
+            {
+                int value = 0;
+                while ( ifs >> std::ws && ifs.peek() == '#' )
+                    ifs.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
+                ifs >> value;
+                return value;
+            };
+
+            width = next();
+            height = next();
+            maxval = next();
+            ifs.get();
+        }
+        else if ( magic == "P7" )
+        {
+            std::string key;
+            while ( ifs >> key && key != "ENDHDR" )
+            {
+                if ( key == "WIDTH" ) ifs >> width;
+                else if ( key == "HEIGHT" ) ifs >> height;
+                else if ( key == "DEPTH" ) ifs >> depth;
+                else if ( key == "MAXVAL" ) ifs >> maxval;
+                else ifs.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
+            }
+            ifs.get();
+        }
+
+        if ( width <= 0 || height <= 0 || maxval != 255 || ( depth != 3 && depth != 4 ) )
+            return false;
+
+        std::vector<std::uint8_t> data( std::size_t( width ) * height * depth );
+        if ( !ifs.read( reinterpret_cast<char *>( data.data() ), data.size() ) )
+            return false;
+
+        tex.width = width;
+        tex.height = height;
+        tex.pixels.resize( std::size_t( width ) * height );
+        for ( std::size_t i = 0; i < tex.pixels.size(); i++ )
+        {
+            const auto * px = data.data() + i * depth;
+            tex.pixels[i] = premultiply( pack( px[0], px[1], px[2], depth == 4 ? px[3] : 255 ) );
+        }
+
+        return true;
+    }
+
+    struct tile
+    {
+        window * surface = nullptr;
+        box bounds;
+        std::vector<std::size_t> commands;
+    };
+
+    struct worker
+    {
+        std::vector<box> _clips;
+        outline _outline;
+        rasterizer _rasterizer;
+        std::vector<std::uint32_t> _row;
+    };
+
+    class thread_pool
+    {
+    private:
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<std::size_t> tasks;
+        };
+
+    public:
+        thread_pool( std::size_t count )
+            : _queues( std::max<std::size_t>( count, 1 ) )
+        {
+            for ( std::size_t i = 1; i < _queues.size(); i++ )
+                _threads.emplace_back( [this, i]() { loop( i ); } );
+        }
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _stop = true;
+            }
+            _wake.notify_all();
+
+            for ( auto & it : _threads )
+                it.join();
+        }
+
+    public:
+        std::size_t size() const
+        {
+            return _queues.size();
+        }
+        // the calling thread works as worker 0, returns once every task has finished
+        void run( std::size_t count, std::function<void( std::size_t worker, std::size_t task )> task )
+        {
+            if ( count == 0 )
+                return;
+
+            _task = std::move( task );
+            _remaining = count;
+            for ( std::size_t i = 0; i < count; i++ )
+            {
+                auto & q = _queues[i % _queues.size()];
+                std::lock_guard<std::mutex> lock( q.mutex );
+                q.tasks.push_back( i );
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                ++_generation;
+            }
+            _wake.notify_all();
+
+            process( 0 );
+
+            std::unique_lock<std::mutex> lock( _mutex );
+            _done.wait( lock, [this]() { return _remaining == 0; } );
+        }
+
+    private:
+        void loop( std::size_t self )
+        {
+            std::size_t generation = 0;
+            while ( true )
+            {
+                {
+                    std::unique_lock<std::mutex> lock( _mutex );
+                    _wake.wait( lock, [&]() { return _stop || _generation != generation; } );
+                    if ( _stop )
+                        return;
+                    generation = _generation;
+                }
+
+                process( self );
+            }
+        }
+        void process( std::size_t self )
+        {
+            std::size_t task = 0;
+            while ( pop( self, task ) )
+            {
+                _task( self, task );
+
+                if ( --_remaining == 0 )
+                {
+                    std::lock_guard<std::mutex> lock( _mutex );
+                    _done.notify_all();
+                }
+            }
+        }
+        bool pop( std::size_t self, std::size_t & task )
+        {
+            {
+                auto & q = _queues[self];
+                std::lock_guard<std::mutex> lock( q.mutex );
+                if ( !q.tasks.empty() )
+                {
+                    task = q.tasks.front();
+                    q.tasks.pop_front();
+                    return true;
+                }
+            }
+
+            // steal from the back of the other queues
+            for ( std::size_t i = 1; i < _queues.size(); i++ )
+            {
+                auto & q = _queues[( self + i ) % _queues.size()];
+                std::lock_guard<std::mutex> lock( q.mutex );
+                if ( !q.tasks.empty() )
+                {
+                    task = q.tasks.back();
+                    q.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        bool _stop = false;
+        std::size_t _generation = 0;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        std::atomic<std::size_t> _remaining = 0;
+        std::function<void( std::size_t, std::size_t )> _task;
+        std::vector<queue> _queues;
+        std::vector<std::thread> _threads;
+    };
+}
+
+struct software_implement::private_p
+{
+public:
+    void composite( worker & t, window & w, const box & clip, const paint & p )
+    {
+        t._rasterizer.rasterize( clip, [&]( int y, int x, int count, const std::uint8_t * coverage )
+        {
+            auto * row = w.pixels.data() + std::size_t( y ) * w.width;
+
+            for ( const auto & it : t._clips )
+            {
+                if ( y < it.y0 || y >= it.y1 )
+                    continue;
+
+                int beg = std::max( x, it.x0 ), end = std::min( x + count, it.x1 );
+                if ( beg >= end )
+                    continue;
+
+                if ( p.solid() )
+                {
+                    kernels().blend_color( row + beg, p.color(), coverage + ( beg - x ), end - beg );
+                }
+                else
+                {
+                    t._row.resize( end - beg );
+                    p.shade( beg, y, end - beg, t._row.data() );
+                    kernels().blend_pixels( row + beg, t._row.data(), coverage + ( beg - x ), end - beg );
+                }
+            }
+        } );
+    }
+    void fill( worker & t, window & w, const box & clip, const paint & p )
+    {
+        if ( !p.empty() )
+        {
+            t._rasterizer.fill( t._outline );
+            composite( t, w, clip, p );
+        }
+    }
+    void stroke( worker & t, window & w, const box & clip, const xui::stroke & s )
+    {
+        paint p( s.color );
+        if ( !p.empty() )
+        {
+            stroker::stroke( t._rasterizer, t._outline, s );
+            composite( t, w, clip, p );
+        }
+    }
+    xui::size measure( const font & fnt, std::u32string_view text, std::vector<float> * lines = nullptr ) const
+    {
+        xui::size result;
+
+        if ( fnt.face == nullptr )
+        {
+            result.w = text.size() * fnt.size * 0.5f;
+            result.h = fnt.size * 1.2f;
+            if ( lines ) lines->push_back( result.w );
+            return result;
+        }
+
+        float scale = float( fnt.size ) / fnt.face->units_per_em;
+        float line_height = ( fnt.face->ascender - fnt.face->descender + fnt.face->line_gap ) * scale;
+
+        float width = 0;
+        for ( std::size_t i = 0; i <= text.size(); i++ )
+        {
+            if ( i == text.size() || text[i] == U'\n' )
+            {
+                if ( lines ) lines->push_back( width );
+                result.w = std::max( result.w, width );
+                result.h += line_height;
+                width = 0;
+            }
+            else
+            {
+                width += fnt.face->advance( fnt.face->glyph_index( text[i] ) ) * scale;
+            }
+        }
+
+        return result;
+    }
+    void text( worker & t, window & w, const box & clip, const xui::drawcmd::text_element & element )
+    {
+        if ( element.font >= _fonts.size() || !_fonts[element.font].valid || _fonts[element.font].face == nullptr )
+            return;
+
+        const auto & fnt = _fonts[element.font];
+        const auto & fc = *fnt.face;
+        auto text = utf8_decode( element.text );
+
+        std::vector<float> lines;
+        auto size = measure( fnt, text, &lines );
+
+        float scale = float( fnt.size ) / fc.units_per_em;
+        float line_height = ( fc.ascender - fc.descender + fc.line_gap ) * scale;
+        float skew = ( fnt.flag & xui::font_flag::FONT_ITALIC ) ? 0.2f : 0.0f;
+
+        float y = element.rect.y;
+        if ( element.align & xui::alignment_flag::ALIGN_BOTTOM )
+            y = element.rect.y + element.rect.h - size.h;
+        if ( element.align & xui::alignment_flag::ALIGN_VCENTER )
+            y = element.rect.y + ( element.rect.h - size.h ) / 2;
+
+        std::vector<xui::rect> decorations;
+        float thickness = std::max( 1.0f, fnt.size / 14.0f );
+
+        std::size_t line = 0;
+        float x = 0;
+        for ( std::size_t i = 0; i <= text.size(); i++ )
+        {
+            if ( i == 0 || text[i - 1] == U'\n' )
+            {
+                x = element.rect.x;
+                if ( element.align & xui::alignment_flag::ALIGN_RIGHT )
+                    x = element.rect.x + element.rect.w - lines[line];
+                if ( element.align & xui::alignment_flag::ALIGN_HCENTER )
+                    x = element.rect.x + ( element.rect.w - lines[line] ) / 2;
+
+                float baseline = y + line * line_height + fc.ascender * scale;
+                if ( fnt.flag & xui::font_flag::FONT_UNDERLINE )
+                    decorations.push_back( { x, baseline + thickness, lines[line], thickness } );
+                if ( fnt.flag & xui::font_flag::FONT_STRIKEOUT )
+                    decorations.push_back( { x, baseline - fnt.size * 0.3f, lines[line], thickness } );
+
+                ++line;
+            }
+
+            if ( i == text.size() || text[i] == U'\n' )
+                continue;
+
+            auto g = fc.glyph_index( text[i] );
+            fc.emit( g, { x, y + ( line - 1 ) * line_height + fc.ascender * scale }, scale, skew, t._outline );
+            x += fc.advance( g ) * scale;
+        }
+
+        box area = clip.intersected( box::from( element.rect ) );
+        paint p( element.color );
+
+        if ( fnt.flag & xui::font_flag::FONT_BOLD )
+        {
+            xui::stroke bold;
+            bold.style = xui::stroke::SOLID;
+            bold.width = std::max( 1.0f, fnt.size / 24.0f );
+            bold.color = element.color;
+            stroker::stroke( t._rasterizer, t._outline, bold );
+            composite( t, w, area, p );
+        }
+
+        fill( t, w, area, p );
+        t._outline.clear();
+
+        for ( const auto & it : decorations )
+            t._outline.rect( it, {} );
+        fill( t, w, area, p );
+        t._outline.clear();
+    }
+    void path( outline & o, const xui::drawcmd::path_element & element )
+    {
+        auto pt = element.points.data();
+        xui::vec2 m, c;
+        auto prev = xui::drawcmd::path_element::CLOSEPATH;
+
+        for ( auto cmd : element.commands )
+        {
+            switch ( cmd )
+            {
+            case xui::drawcmd::path_element::MOVETO:
+                m = pt[0];
+                o.move_to( m );
+                break;
+            case xui::drawcmd::path_element::LINETO:
+                m = pt[0];
+                o.line_to( m );
+                break;
+            case xui::drawcmd::path_element::CURVETO:
+                o.cubic_to( pt[0], pt[1], pt[2] );
+                c = pt[1];
+                m = pt[2];
+                break;
+            case xui::drawcmd::path_element::SMOOTH_CURVETO:
+            {
+                auto c1 = ( prev == xui::drawcmd::path_element::CURVETO || prev == xui::drawcmd::path_element::SMOOTH_CURVETO ) ? m * 2 - c : m;
+                o.cubic_to( c1, pt[0], pt[1] );
+                c = pt[0];
+                m = pt[1];
+            }
+                break;
+            case xui::drawcmd::path_element::QUADRATIC_CURVETO:
+                o.quad_to( pt[0], pt[1] );
+                c = pt[0];
+                m = pt[1];
+                break;
+            case xui::drawcmd::path_element::SMOOTH_QUADRATIC_CURVETO:
+                c = ( prev == xui::drawcmd::path_element::QUADRATIC_CURVETO || prev == xui::drawcmd::path_element::SMOOTH_QUADRATIC_CURVETO ) ? m * 2 - c : m;
+                o.quad_to( c, pt[0] );
+                m = pt[0];
+                break;
+            case xui::drawcmd::path_element::CLOSEPATH:
+                o.close();
+                break;
+            }
+
+            prev = cmd;
+            pt += xui::drawcmd::path_element::point_count( cmd );
+        }
+    }
+    void draw( worker & t, window & w, const box & clip, const xui::drawlist & list, const xui::drawcmd & cmd )
+    {
+        auto & o = t._outline;
+        const auto & border = list.stroke( cmd );
+        const auto & brush = cmd.fill < _paints.size() ? _paints[cmd.fill] : _paints.front();
+
+        list.visit( cmd, xui::overload(
+        [&]( const xui::drawcmd::text_element & element )
+        {
+            text( t, w, clip, element );
+        },
+        [&]( const xui::drawcmd::line_element & element )
+        {
+            o.move_to( element.p1 );
+            o.line_to( element.p2 );
+            stroke( t, w, clip, border );
+        },
+        [&]( const xui::drawcmd::rect_element & element )
+        {
+            o.rect( element.rect, border.radius );
+            fill( t, w, clip, brush );
+            stroke( t, w, clip, border );
+        },
+        [&]( const xui::drawcmd::path_element & element )
+        {
+            path( o, element );
+            fill( t, w, clip, brush );
+            stroke( t, w, clip, border );
+        },
+        [&]( const xui::drawcmd::image_element & element )
+        {
+            if ( element.id < _textures.size() )
+            {
+                o.rect( element.rect, {} );
+                fill( t, w, clip, paint( _textures[element.id], element.rect ) );
+            }
+        },
+        [&]( const xui::drawcmd::circle_element & element )
+        {
+            o.ellipse( element.center, { element.radius, element.radius } );
+            fill( t, w, clip, brush );
+            stroke( t, w, clip, border );
+        },
+        [&]( const xui::drawcmd::ellipse_element & element )
+        {
+            o.ellipse( element.center, element.radius );
+            fill( t, w, clip, brush );
+            stroke( t, w, clip, border );
+        },
+        [&]( const xui::drawcmd::polygon_element & element )
+        {
+            o.polygon( element.points );
+            fill( t, w, clip, brush );
+            stroke( t, w, clip, border );
+        }
+        ) );
+
+        o.clear();
+    }
+    void draw_tile( worker & t, const tile & tl, const xui::drawlist & list )
+    {
+        auto & w = *tl.surface;
+
+        t._clips.clear();
+        for ( const auto & it : w.clips )
+        {
+            box b = it.intersected( tl.bounds );
+            if ( b.empty() )
+                continue;
+
+            for ( int y = b.y0; y < b.y1; y++ )
+                std::fill( w.pixels.begin() + std::size_t( y ) * w.width + b.x0, w.pixels.begin() + std::size_t( y ) * w.width + b.x1, 0 );
+
+            t._clips.push_back( b );
+        }
+
+        box clip = t._clips.front();
+        for ( const auto & it : t._clips )
+            clip = clip.united( it );
+
+        for ( auto i : tl.commands )
+        {
+            const auto & cmd = list[i];
+
+            box c = cmd.clip != 0 ? clip.intersected( box::from( list.clip( cmd ) ) ) : clip;
+            if ( !c.empty() )
+                draw( t, w, c, list, cmd );
+        }
+    }
+    // numbers the tiles under the clips of a surface from tiles on and returns the new count
+    std::size_t split_tiles( window & w, std::size_t tiles )
+    {
+        box bounds = { 0, 0, w.width, w.height };
+
+        // only tiles touching the damage get work, the rest stay npos
+        int columns = ( w.width + TILE_SIZE - 1 ) / TILE_SIZE;
+        int rows = ( w.height + TILE_SIZE - 1 ) / TILE_SIZE;
+        w.tiles.assign( std::size_t( columns ) * rows, std::numeric_limits<std::size_t>::max() );
+        for ( const auto & it : w.clips )
+        {
+            for ( int y = it.y0 / TILE_SIZE; y <= ( it.y1 - 1 ) / TILE_SIZE; y++ )
+            {
+                for ( int x = it.x0 / TILE_SIZE; x <= ( it.x1 - 1 ) / TILE_SIZE; x++ )
+                {
+                    auto & index = w.tiles[std::size_t( y ) * columns + x];
+                    if ( index != std::numeric_limits<std::size_t>::max() )
+                        continue;
+
+                    index = tiles++;
+                    if ( _tiles.size() < tiles )
+                        _tiles.resize( tiles );
+
+                    auto & tl = _tiles[index];
+                    tl.surface = &w;
+                    tl.bounds = box{ x * TILE_SIZE, y * TILE_SIZE, ( x + 1 ) * TILE_SIZE, ( y + 1 ) * TILE_SIZE }.intersected( bounds );
+                    tl.commands.clear();
+                }
+            }
+        }
+
+        return tiles;
+    }
+    // commands are appended in draw order, so every tile keeps the z order of the list
+    void bin_command( window & w, const xui::drawcmd & cmd, std::size_t i )
+    {
+        if ( w.clips.empty() )
+            return;
+
+        box b = box{ cmd.left, cmd.top, cmd.right, cmd.bottom }.intersected( { 0, 0, w.width, w.height } );
+        if ( b.empty() )
+            return;
+
+        int columns = ( w.width + TILE_SIZE - 1 ) / TILE_SIZE;
+        for ( int y = b.y0 / TILE_SIZE; y <= ( b.y1 - 1 ) / TILE_SIZE; y++ )
+        {
+            for ( int x = b.x0 / TILE_SIZE; x <= ( b.x1 - 1 ) / TILE_SIZE; x++ )
+            {
+                auto index = w.tiles[std::size_t( y ) * columns + x];
+                if ( index != std::numeric_limits<std::size_t>::max() )
+                    _tiles[index].commands.push_back( i );
+            }
+        }
+    }
+    void draw_tiles( std::size_t tiles, const xui::drawlist & list )
+    {
+        if ( tiles == 0 )
+            return;
+
+        if ( !_pool )
+        {
+            auto count = _thread_count != 0 ? _thread_count : std::max<std::size_t>( std::thread::hardware_concurrency(), 1 );
+            _pool = std::make_unique<thread_pool>( count );
+            _workers.resize( count );
+        }
+
+        // a tile never touches pixels outside its bounds, so the result does not depend on the thread count
+        _pool->run( tiles, [&]( std::size_t worker, std::size_t task )
+        {
+            draw_tile( _workers[worker], _tiles[task], list );
+        } );
+    }
+    // resolved fills hold texture pointers, so they are rebuilt whenever the texture table changes
+    void refresh_paints()
+    {
+        for ( std::size_t i = 0; i < _fills.size(); i++ )
+            _paints[i] = paint( _fills[i], _textures );
+    }
+
+public:
+    std::vector<font> _fonts;
+    std::vector<std::unique_ptr<font_face>> _faces;
+    std::vector<window> _windows;
+    std::vector<texture> _textures;
+    std::map<xui::texture_id, window> _targets;
+    std::size_t _target_serial = 0;
+    std::vector<xui::filled> _fills{ 1 };
+    std::vector<paint> _paints{ 1 };
+    std::map<std::string, std::string, std::less<>> _clipboard;
+
+public:
+    std::size_t _thread_count = 0;
+    std::unique_ptr<thread_pool> _pool;
+    std::vector<worker> _workers;
+    std::vector<tile> _tiles;
+};
+
+software_implement::software_implement()
+    : _p( new private_p )
+{
+}
+
+software_implement::~software_implement()
+{
+    delete _p;
+}
+
+void software_implement::init()
+{
+}
+
+void software_implement::update( const std::function<const xui::drawlist &()> & paint )
+{
+    render( paint() );
+
+    present();
+}
+
+void software_implement::release()
+{
+    _p->_pool.reset();
+    _p->_workers.clear();
+    _p->_tiles.clear();
+    _p->_windows.clear();
+    _p->_targets.clear();
+    _p->_textures.clear();
+    _p->_fonts.clear();
+    _p->_faces.clear();
+    _p->_clipboard.clear();
+}
+
+xui::window_id software_implement::create_window( std::string_view title, xui::texture_id icon, const xui::rect & rect, xui::window_id parent )
+{
+    auto it = std::find_if( _p->_windows.begin(), _p->_windows.end(), []( const auto & val ) { return !val.valid; } );
+    if ( it == _p->_windows.end() )
+        it = _p->_windows.emplace( _p->_windows.end() );
+
+    *it = {};
+    it->valid = true;
+    it->title = title;
+    it->parent = parent;
+    it->resize( rect );
+
+    return std::distance( _p->_windows.begin(), it );
+}
+
+xui::window_id software_implement::get_window_parent( xui::window_id id ) const
+{
+    if ( id >= _p->_windows.size() )
+        return xui::invalid_window_id;
+
+    return _p->_windows[id].parent;
+}
+
+void software_implement::set_window_parent( xui::window_id id, xui::window_id parent )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    _p->_windows[id].parent = parent;
+}
+
+xui::window_status software_implement::get_window_status( xui::window_id id ) const
+{
+    if ( id >= _p->_windows.size() || !_p->_windows[id].valid )
+        return xui::window_status( 0 );
+
+    return xui::window_status( _p->_windows[id].status );
+}
+
+void software_implement::set_window_status( xui::window_id id, xui::window_status show )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    auto & w = _p->_windows[id];
+    switch ( show )
+    {
+    case xui::window_status::WINDOW_SHOW:
+        w.status = ( w.status & ~xui::window_status::WINDOW_HIDE ) | xui::window_status::WINDOW_SHOW;
+        break;
+    case xui::window_status::WINDOW_HIDE:
+        w.status = ( w.status & ~xui::window_status::WINDOW_SHOW ) | xui::window_status::WINDOW_HIDE;
+        break;
+    case xui::window_status::WINDOW_RESTORE:
+        if ( w.status & xui::window_status::WINDOW_MAXIMIZE )
+            w.resize( w.rrect );
+        w.status = xui::window_status::WINDOW_SHOW;
+        break;
+    case xui::window_status::WINDOW_MINIMIZE:
+        w.status = xui::window_status::WINDOW_SHOW | xui::window_status::WINDOW_MINIMIZE;
+        break;
+    case xui::window_status::WINDOW_MAXIMIZE:
+        if ( !( w.status & xui::window_status::WINDOW_MAXIMIZE ) )
+            w.rrect = w.rect;
+        w.status = xui::window_status::WINDOW_SHOW | xui::window_status::WINDOW_MAXIMIZE;
+        break;
+    }
+}
+
+xui::rect software_implement::get_window_rect( xui::window_id id ) const
+{
+    if ( id >= _p->_windows.size() )
+        return {};
+
+    return _p->_windows[id].rect;
+}
+
+void software_implement::set_window_rect( xui::window_id id, const xui::rect & rect )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    auto & w = _p->_windows[id];
+    if ( std::ceil( rect.w ) != w.width || std::ceil( rect.h ) != w.height )
+        w.resize( rect );
+    else
+        w.rect = rect;
+}
+
+std::string software_implement::get_window_title( xui::window_id id ) const
+{
+    if ( id >= _p->_windows.size() )
+        return {};
+
+    return _p->_windows[id].title;
+}
+
+void software_implement::set_window_title( xui::window_id id, std::string_view title )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    _p->_windows[id].title = title;
+}
+
+void software_implement::remove_window( xui::window_id id )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    _p->_windows[id] = {};
+}
+
+bool software_implement::load_font_file( std::string_view filename )
+{
+    std::ifstream ifs( std::string( filename ), std::ios::binary );
+    if ( !ifs )
+        return false;
+
+    std::vector<std::uint8_t> data( ( std::istreambuf_iterator<char>( ifs ) ), std::istreambuf_iterator<char>() );
+
+    auto fc = std::make_unique<font_face>();
+    if ( !fc->load( std::move( data ) ) )
+        return false;
+
+    _p->_faces.push_back( std::move( fc ) );
+    return true;
+}
+
+xui::font_id software_implement::create_font( std::string_view family, int size, xui::font_flag flag )
+{
+    auto it = std::find_if( _p->_faces.begin(), _p->_faces.end(), [&]( const auto & val ) { return val->family == family; } );
+    if ( it == _p->_faces.end() )
+    {
+        if ( family != FONT_DEFAULT )
+            return xui::invalid_font_id;
+
+        if ( _p->_faces.empty() )
+        {
+            for ( auto file : default_font_files )
+            {
+                if ( load_font_file( file ) )
+                    break;
+            }
+        }
+        it = _p->_faces.begin();
+    }
+
+    auto fit = std::find_if( _p->_fonts.begin(), _p->_fonts.end(), []( const auto & val ) { return !val.valid; } );
+    if ( fit == _p->_fonts.end() )
+        fit = _p->_fonts.emplace( _p->_fonts.end() );
+
+    fit->size = size;
+    fit->flag = flag;
+    fit->valid = true;
+    fit->family = family;
+    fit->face = it != _p->_faces.end() ? it->get() : nullptr;
+
+    return std::distance( _p->_fonts.begin(), fit );
+}
+
+xui::size software_implement::font_size( xui::font_id id, std::string_view text ) const
+{
+    if ( id >= _p->_fonts.size() || !_p->_fonts[id].valid )
+        return {};
+
+    return _p->measure( _p->_fonts[id], utf8_decode( text ) );
+}
+
+void software_implement::remove_font( xui::font_id id )
+{
+    if ( id >= _p->_fonts.size() )
+        return;
+
+    _p->_fonts[id] = {};
+}
+
+xui::texture_id software_implement::create_texture( std::string_view filename )
+{
+    auto it = std::find_if( _p->_textures.begin(), _p->_textures.end(), [&]( const texture & val )
+    {
+        return val.name == filename;
+    } );
+    if ( it != _p->_textures.end() )
+        return std::distance( _p->_textures.begin(), it );
+
+    texture tex;
+    if ( !load_netpbm( filename, tex ) )
+        return xui::invalid_texture_id;
+
+    auto id = create_texture( filename, tex.width, tex.height, {} );
+    _p->_textures[id].pixels = std::move( tex.pixels );
+
+    return id;
+}
+
+xui::texture_id software_implement::create_texture( std::string_view name, int width, int height, std::span<const std::uint32_t> pixels )
+{
+    auto it = std::find_if( _p->_textures.begin(), _p->_textures.end(), [&]( const texture & val ) { return val.name == name; } );
+    if ( it == _p->_textures.end() )
+        it = std::find_if( _p->_textures.begin(), _p->_textures.end(), []( const texture & val ) { return val.name.empty(); } );
+    if ( it == _p->_textures.end() )
+        it = _p->_textures.emplace( _p->_textures.end() );
+
+    it->name = name;
+    it->width = width;
+    it->height = height;
+    it->pixels.resize( std::size_t( width ) * height );
+    for ( std::size_t i = 0; i < it->pixels.size() && i < pixels.size(); i++ )
+        it->pixels[i] = premultiply( pixels[i] );
+
+    _p->refresh_paints();
+
+    return std::distance( _p->_textures.begin(), it );
+}
+
+xui::size software_implement::texture_size( xui::texture_id id ) const
+{
+    if ( id >= _p->_textures.size() )
+        return {};
+
+    return { (float)_p->_textures[id].width, (float)_p->_textures[id].height };
+}
+
+void software_implement::remove_texture( xui::texture_id id )
+{
+    if ( id >= _p->_textures.size() )
+        return;
+
+    _p->_textures[id] = {};
+    _p->refresh_paints();
+}
+
+xui::texture_id software_implement::create_render_target( int width, int height )
+{
+    // the name only keeps create_texture from handing out a slot that is still in use
+    auto id = create_texture( "render-target://" + std::to_string( _p->_target_serial++ ), width, height, {} );
+
+    _p->_targets[id].resize( { 0, 0, (float)width, (float)height } );
+
+    return id;
+}
+
+void software_implement::update_render_target( xui::texture_id id, const xui::drawlist & list )
+{
+    auto it = _p->_targets.find( id );
+    if ( it == _p->_targets.end() || id >= _p->_textures.size() )
+        return;
+
+    // the surface is redrawn whole, both it and the texture hold premultiplied pixels
+    auto & w = it->second;
+    w.clips.assign( 1, { 0, 0, w.width, w.height } );
+
+    auto tiles = _p->split_tiles( w, 0 );
+    for ( std::size_t i = 0; i < list.size(); i++ )
+        _p->bin_command( w, list[i], i );
+    _p->draw_tiles( tiles, list );
+
+    _p->_textures[id].pixels = w.pixels;
+}
+
+void software_implement::remove_render_target( xui::texture_id id )
+{
+    _p->_targets.erase( id );
+    remove_texture( id );
+}
+
+std::string software_implement::get_clipboard_data( xui::window_id id, std::string_view mime ) const
+{
+    auto it = _p->_clipboard.find( mime );
+    return it != _p->_clipboard.end() ? it->second : std::string();
+}
+
+bool software_implement::set_clipboard_data( xui::window_id id, std::string_view mime, std::string_view data )
+{
+    _p->_clipboard.insert_or_assign( std::string( mime ), std::string( data ) );
+    return true;
+}
+
+xui::vec2 software_implement::get_cursor_dt( xui::window_id id ) const
+{
+    return _p->_windows[id].events.dt();
+}
+
+xui::vec2 software_implement::get_cursor_pos( xui::window_id id ) const
+{
+    return _p->_windows[id].events.pos();
+}
+
+xui::vec2 software_implement::get_cusor_wheel( xui::window_id id ) const
+{
+    return _p->_windows[id].events.wheel();
+}
+
+std::string software_implement::get_unicodes( xui::window_id id ) const
+{
+    return utf8_encode( _p->_windows[id].events._unicodes );
+}
+
+int software_implement::get_event( xui::window_id id, xui::event key ) const
+{
+    return _p->_windows[id].events[(size_t)key];
+}
+
+std::span<xui::vec2> software_implement::get_touchs( xui::window_id id ) const
+{
+    return _p->_windows[id].events._touchs;
+}
+
+void software_implement::create_paint( xui::paint_id id, const xui::border & stroke )
+{
+    // strokes are read from the draw list, only their color is resolved and that is cheap
+}
+
+void software_implement::create_paint( xui::paint_id id, const xui::filled & fill )
+{
+    if ( id >= _p->_fills.size() )
+    {
+        _p->_fills.resize( id + 1 );
+        _p->_paints.resize( id + 1 );
+    }
+
+    _p->_fills[id] = fill;
+    _p->_paints[id] = paint( fill, _p->_textures );
+}
+
+void software_implement::remove_paint( xui::paint_id id )
+{
+    if ( id >= _p->_fills.size() )
+        return;
+
+    _p->_fills[id] = {};
+    _p->_paints[id] = {};
+}
+
+void software_implement::damage_window( xui::window_id id, std::span<const xui::rect> rects )
+{
+    if ( id >= _p->_windows.size() )
+        return;
+
+    _p->_windows[id].damages.insert( _p->_windows[id].damages.end(), rects.begin(), rects.end() );
+}
+
+void software_implement::set_thread_count( std::size_t count )
+{
+    _p->_thread_count = count;
+    _p->_pool.reset();
+    _p->_workers.clear();
+}
+
+std::span<const std::uint32_t> software_implement::get_window_pixels( xui::window_id id ) const
+{
+    if ( id >= _p->_windows.size() )
+        return {};
+
+    return _p->_windows[id].pixels;
+}
+
+void software_implement::present()
+{
+    for ( auto & it : _p->_windows )
+    {
+        it.invalid = false;
+        it.damages.clear();
+        it.events.flush();
+    }
+}
+
+void software_implement::render( const xui::drawlist & list )
+{
+    std::size_t tiles = 0;
+    for ( auto & w : _p->_windows )
+    {
+        w.clips.clear();
+        w.tiles.clear();
+        if ( !w.valid || ( !w.invalid && w.damages.empty() ) )
+            continue;
+
+        box bounds = { 0, 0, w.width, w.height };
+        if ( w.invalid )
+        {
+            w.clips.push_back( bounds );
+        }
+        else
+        {
+            // merge overlapping damage so every pixel is blended at most once per command
+            for ( const auto & it : w.damages )
+            {
+                box b = box::from( it ).intersected( bounds );
+                if ( b.empty() )
+                    continue;
+
+                for ( auto c = w.clips.begin(); c != w.clips.end(); )
+                {
+                    if ( !c->intersected( b ).empty() )
+                    {
+                        b = b.united( *c );
+                        w.clips.erase( c );
+                        c = w.clips.begin();
+                    }
+                    else
+                    {
+                        ++c;
+                    }
+                }
+                w.clips.push_back( b );
+            }
+        }
+
+        tiles = _p->split_tiles( w, tiles );
+    }
+
+    for ( std::size_t i = 0; i < list.size(); i++ )
+    {
+        const auto & cmd = list[i];
+        if ( cmd.id < _p->_windows.size() )
+            _p->bin_command( _p->_windows[cmd.id], cmd, i );
+    }
+
+    _p->draw_tiles( tiles, list );
+}
+
+void software_implement::set_unicode( xui::window_id id, wchar_t unicode )
+{
+    _p->_windows[id].events._unicodes.push_back( unicode );
+}
+
+void software_implement::set_wheel( xui::window_id id, const xui::vec2 & dt )
+{
+    _p->_windows[id].events._cursorwheel = dt;
+}
+
+void software_implement::set_cursor( xui::window_id id, const xui::vec2 & pos )
+{
+    _p->_windows[id].events._cursorpos = pos;
+}
+
+void software_implement::set_touchs( xui::window_id id, std::span<xui::vec2> touchs )
+{
+    _p->_windows[id].events._touchs.assign( touchs.begin(), touchs.end() );
+}
+
+void software_implement::set_event( xui::window_id id, xui::event key, int val )
+{
+    if ( id != xui::invalid_window_id )
+    {
+        if ( key >= xui::event::WINDOW_EVENT_BEG && key <= xui::event::WINDOW_EVENT_END )
+        {
+            if ( key == xui::event::WINDOW_ACTIVE && val == 0 )
+            {
+                _p->_windows[id].events._cursorpos = {};
+                _p->_windows[id].events._cursorold = {};
+                _p->_windows[id].events._cursorwheel = {};
+
+                std::fill( _p->_windows[id].events._events.begin() + (size_t)xui::event::MOUSE_EVENT_BEG, _p->_windows[id].events._events.begin() + (size_t)xui::event::MOUSE_EVENT_END + 1, 0 );
+            }
+
+            _p->_windows[id].events._events[(size_t)key] = val;
+        }
+        else if ( key >= xui::event::KEY_EVENT_BEG && key <= xui::event::KEY_EVENT_END )
+        {
+            _p->_windows[id].events._events[(size_t)key] = val;
+        }
+        else if ( key >= xui::event::MOUSE_EVENT_BEG && key <= xui::event::MOUSE_EVENT_END )
+        {
+            _p->_windows[id].events._events[(size_t)key] = val;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "xui.h"
+
+class software_implement : public xui::implement
+{
+private:
+	struct private_p;
+
+public:
+	software_implement();
+	~software_implement();
+
+public:
+	void init();
+	void update( const std::function<const xui::drawlist &()> & paint );
+	void release();
+
+public:
+	xui::window_id create_window( std::string_view title, xui::texture_id icon, const xui::rect & rect, xui::window_id parent = xui::invalid_window_id ) override;
+	xui::window_id get_window_parent( xui::window_id id ) const override;
+	void set_window_parent( xui::window_id id, xui::window_id parent ) override;
+	xui::window_status get_window_status( xui::window_id id ) const override;
+	void set_window_status( xui::window_id id, xui::window_status show ) override;
+	xui::rect get_window_rect( xui::window_id id ) const override;
+	void set_window_rect( xui::window_id id, const xui::rect & rect ) override;
+	std::string get_window_title( xui::window_id id ) const override;
+	void set_window_title( xui::window_id id, std::string_view title ) override;
+	void remove_window( xui::window_id id ) override;
+
+public:
+	bool load_font_file( std::string_view filename ) override;
+	xui::font_id create_font( std::string_view family, int size, xui::font_flag flag ) override;
+	xui::size font_size( xui::font_id id, std::string_view text ) const override;
+	void remove_font( xui::font_id id ) override;
+
+public:
+	xui::texture_id create_texture( std::string_view filename ) override;
+	xui::size texture_size( xui::texture_id id ) const override;
+	void remove_texture( xui::texture_id id ) override;
+
+public:
+	xui::vec2 get_cursor_dt( xui::window_id id ) const override;
+	xui::vec2 get_cursor_pos( xui::window_id id ) const override;
+	xui::vec2 get_cusor_wheel( xui::window_id id ) const override;
+	std::string get_unicodes( xui::window_id id ) const override;
+	int get_event( xui::window_id id, xui::event key ) const override;
+	std::span<xui::vec2> get_touchs( xui::window_id id ) const override;
+	std::string get_clipboard_data( xui::window_id id, std::string_view mime ) const override;
+	bool set_clipboard_data( xui::window_id id, std::string_view mime, std::string_view data ) override;
+
+public:
+	void create_paint( xui::paint_id id, const xui::border & stroke ) override;
+	void create_paint( xui::paint_id id, const xui::filled & fill ) override;
+	void remove_paint( xui::paint_id id ) override;
+
+public:
+	xui::texture_id create_render_target( int width, int height ) override;
+	void update_render_target( xui::texture_id id, const xui::drawlist & list ) override;
+	void remove_render_target( xui::texture_id id ) override;
+
+public:
+	void damage_window( xui::window_id id, std::span<const xui::rect> rects ) override;
+
+public:
+	// pixels are straight rgba in xui::color byte order
+	xui::texture_id create_texture( std::string_view name, int width, int height, std::span<const std::uint32_t> pixels );
+	// premultiplied rgba in xui::color byte order, row stride is the window width
+	std::span<const std::uint32_t> get_window_pixels( xui::window_id id ) const;
+	// tiles are rendered on this many threads, 0 uses one per hardware thread
+	void set_thread_count( std::size_t count );
+
+public:
+	// cursor positions are window local
+	void set_unicode( xui::window_id id, wchar_t unicode );
+	void set_wheel( xui::window_id id, const xui::vec2 & dt );
+	void set_cursor( xui::window_id id, const xui::vec2 & pos );
+	void set_touchs( xui::window_id id, std::span<xui::vec2> touchs );
+	void set_event( xui::window_id id, xui::event key, int val );
+
+private:
+	void present();
+	void render( const xui::drawlist & list );
+
+private:
+	private_p * _p;
+};
@@ -0,0 +1,127 @@
+// the span kernels live in an anonymous namespace, the benchmark compiles them in its own translation unit
+#include "software_implement.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	static constexpr int SPAN_W = 1920;
+	static constexpr int SPAN_H = 1080;
+
+	struct span_case
+	{
+		const char * name;
+		span_kernels kernels;
+	};
+
+	struct span_data
+	{
+		std::vector<float> cells;
+		std::vector<std::uint8_t> coverage;
+		std::vector<std::uint32_t> dst;
+		std::vector<std::uint32_t> src;
+	};
+
+	// one full-width antialiased span per row, the edges land on fractional pixels like a rasterized rect
+	void reset_cells( span_data & data )
+	{
+		for ( int y = 0; y < SPAN_H; y++ )
+		{
+			float * row = data.cells.data() + y * SPAN_W;
+			std::fill( row, row + SPAN_W, 0.0f );
+			row[0] = 0.75f;
+			row[1] = 0.25f;
+			row[SPAN_W - 2] = -0.5f;
+			row[SPAN_W - 1] = -0.5f;
+		}
+	}
+
+	// best of several 1080p frames in milliseconds, the first frame warms the caches
+	template<typename F> double measure( int frames, F && frame )
+	{
+		double best = 1e30;
+		for ( int i = 0; i <= frames; i++ )
+		{
+			auto beg = std::chrono::steady_clock::now();
+			frame();
+			auto end = std::chrono::steady_clock::now();
+
+			if ( i > 0 )
+				best = std::min( best, std::chrono::duration<double, std::milli>( end - beg ).count() );
+		}
+		return best;
+	}
+}
+
+// fill rate of the coverage and blend kernels alone, on 1920 pixel spans over 1080 rows
+int main( int argc, char ** argv )
+{
+	int frames = argc > 1 ? std::max( 1, std::atoi( argv[1] ) ) : 20;
+
+	std::vector<span_case> cases;
+#ifdef XUI_SOFTWARE_X64
+	// the scalar accumulate is the ungrouped loop the simd kernels finish their tails with
+	auto accumulate_plain = []( const float * cells, std::uint8_t * coverage, int count ) { accumulate_tail( cells, coverage, count, 0 ); };
+	cases.push_back( { "scalar", { accumulate_plain, blend_color_scalar, blend_pixels_scalar } } );
+	cases.push_back( { "sse2", { accumulate_sse2, blend_color_sse2, blend_pixels_sse2 } } );
+	if ( has_avx2() )
+		cases.push_back( { "avx2", { accumulate_sse2, blend_color_avx2, blend_pixels_avx2 } } );
+#else
+	cases.push_back( { "scalar", { accumulate_scalar, blend_color_scalar, blend_pixels_scalar } } );
+#endif
+
+	span_data data;
+	data.cells.resize( SPAN_W * SPAN_H );
+	data.coverage.resize( SPAN_W * SPAN_H );
+	data.dst.resize( SPAN_W * SPAN_H );
+	data.src.assign( SPAN_W * SPAN_H, 0x80402010 );
+	reset_cells( data );
+
+	std::printf( "%-8s %17s %17s %17s %17s\n", "kernel", "accumulate", "opaque", "translucent", "pixels" );
+
+	double base[4] = {};
+	for ( const auto & it : cases )
+	{
+		const auto & k = it.kernels;
+		double ms[4];
+
+		ms[0] = measure( frames, [&]()
+		{
+			for ( int y = 0; y < SPAN_H; y++ )
+				k.accumulate( data.cells.data() + y * SPAN_W, data.coverage.data() + y * SPAN_W, SPAN_W );
+		} );
+		ms[1] = measure( frames, [&]()
+		{
+			for ( int y = 0; y < SPAN_H; y++ )
+				k.blend_color( data.dst.data() + y * SPAN_W, 0xFF3060C0, data.coverage.data() + y * SPAN_W, SPAN_W );
+		} );
+		ms[2] = measure( frames, [&]()
+		{
+			for ( int y = 0; y < SPAN_H; y++ )
+				k.blend_color( data.dst.data() + y * SPAN_W, 0x80183060, data.coverage.data() + y * SPAN_W, SPAN_W );
+		} );
+		ms[3] = measure( frames, [&]()
+		{
+			for ( int y = 0; y < SPAN_H; y++ )
+				k.blend_pixels( data.dst.data() + y * SPAN_W, data.src.data() + y * SPAN_W, data.coverage.data() + y * SPAN_W, SPAN_W );
+		} );
+
+		if ( base[0] == 0 )
+			std::copy( ms, ms + 4, base );
+
+		std::printf( "%-8s", it.name );
+		for ( int i = 0; i < 4; i++ )
+			std::printf( " %5.2fGpx/s %4.1fx", SPAN_W * SPAN_H / ( ms[i] * 1e6 ), base[i] / ms[i] );
+		std::printf( "\n" );
+	}
+
+	std::uint64_t sum = 0;
+	for ( auto pixel : data.dst )
+		sum += pixel;
+	std::printf( "checksum %llx\n", (unsigned long long)sum );
+
+	return 0;
+}
@@ -1,9 +1,16 @@
 ﻿#include "xui.h"
 
 #include <array>
+#include <cassert>
+#include <bit>
+#include <cmath>
+#include <list>
 #include <deque>
 #include <regex>
+#include <charconv>
+#include <mutex>
 #include <memory>
+#include <numeric>
 #include <algorithm>
 #include <iostream>
 
@@ -29,20 +36,573 @@ namespace
         std::pmr::deque<std::string> elements;
         std::pmr::deque<xui::event_status> status;
     };
-}
 
-template<> struct std::formatter< std::span<std::string_view, std::dynamic_extent>, char > : public std::formatter<std::string_view>
-{
-    template<class FormatContext> auto format( const std::span<std::string_view> & p, FormatContext & context ) const
+    std::string_view status_name( xui::event_status status )
     {
-        auto result = context.out();
-        for ( auto it : p )
+        switch ( status )
         {
-            result = std::format_to( result, "{}", it );
+        case xui::DRAG: return "drag";
+        case xui::HOVER: return "hover";
+        case xui::ACTIVE: return "active";
+        case xui::DISABLED: return "disabled";
         }
-        return result;
+
+        return {};
     }
-};
+
+#ifndef NDEBUG
+    // child names are kept as parent plus index or name and only joined when asked for
+    struct control_names
+    {
+        struct entry
+        {
+            entry( std::size_t parent, std::size_t index )
+                : parent( parent ), index( index )
+            {
+            }
+            entry( std::size_t parent, std::string_view name )
+                : parent( parent ), name( name )
+            {
+            }
+
+            std::size_t parent = 0;
+            std::size_t index = 0;
+            std::string name;
+        };
+
+        // children past this many are dropped, the named roots stay
+        static constexpr std::size_t max_children = 1 << 16;
+
+        std::mutex mutex;
+        std::size_t children = 0;
+        std::unordered_map<std::size_t, entry> names;
+
+        static control_names & instance()
+        {
+            static control_names result;
+            return result;
+        }
+
+        template<typename T> void insert( std::size_t hash, std::size_t parent, T && part )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            if ( names.find( hash ) != names.end() )
+                return;
+
+            if ( parent != 0 && ++children > max_children )
+            {
+                std::erase_if( names, []( const auto & it ) { return it.second.parent != 0; } );
+                children = 1;
+            }
+
+            names.try_emplace( hash, parent, std::forward<T>( part ) );
+        }
+        std::string find( std::size_t hash )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            std::string result;
+            auto depth = names.size();
+            for ( auto it = names.find( hash ); it != names.end() && depth-- != 0; it = names.find( it->second.parent ) )
+            {
+                auto part = it->second.parent == 0 || !it->second.name.empty() ? it->second.name : std::to_string( it->second.index );
+                result.insert( 0, result.empty() ? part : part + "/" );
+                if ( it->second.parent == 0 )
+                    return result;
+            }
+
+            return {};
+        }
+    };
+#endif
+
+    template<typename Table> auto & probe( Table & table, std::uint64_t key )
+    {
+        std::uint64_t h = key * 0x9E3779B97F4A7C15ull;
+        std::size_t mask = table.size() - 1;
+
+        for ( std::size_t i = ( h ^ ( h >> 32 ) ) & mask;; i = ( i + 1 ) & mask )
+        {
+            if ( table[i].key == key || table[i].value == std::numeric_limits<std::uint32_t>::max() )
+                return table[i];
+        }
+    }
+
+    class frame_resource : public std::pmr::memory_resource
+    {
+    private:
+        struct block
+        {
+            std::byte * data = nullptr;
+            std::size_t size = 0;
+        };
+
+    public:
+        static constexpr const std::size_t min_block_size = 64 * 1024;
+
+    public:
+        frame_resource( std::pmr::memory_resource * upstream )
+            : _upstream( upstream ), _blocks( upstream )
+        {
+        }
+        ~frame_resource() override
+        {
+            release();
+        }
+
+    public:
+        void reset()
+        {
+            _high_water = std::max( _high_water, _used );
+
+            // a frame that spilled into several blocks gets one block of the combined size next time
+            if ( _blocks.size() > 1 )
+            {
+                auto size = capacity();
+                release();
+                grow( size );
+            }
+
+            _used = 0;
+            _block = 0;
+            _offset = 0;
+        }
+        void reserve( std::size_t size )
+        {
+            if ( size > capacity() )
+            {
+                release();
+                grow( size );
+            }
+        }
+        std::size_t used() const
+        {
+            return _used;
+        }
+        std::size_t high_water() const
+        {
+            return std::max( _high_water, _used );
+        }
+        std::size_t capacity() const
+        {
+            std::size_t result = 0;
+            for ( const auto & it : _blocks )
+                result += it.size;
+            return result;
+        }
+
+    private:
+        void * do_allocate( std::size_t bytes, std::size_t alignment ) override
+        {
+            while ( true )
+            {
+                if ( _block < _blocks.size() )
+                {
+                    auto & cur = _blocks[_block];
+                    auto pos = ( _offset + alignment - 1 ) & ~( alignment - 1 );
+
+                    if ( pos + bytes <= cur.size )
+                    {
+                        _used += pos + bytes - _offset;
+                        _offset = pos + bytes;
+                        return cur.data + pos;
+                    }
+
+                    if ( _block + 1 < _blocks.size() )
+                    {
+                        ++_block;
+                        _offset = 0;
+                        continue;
+                    }
+                }
+
+                grow( std::max( { bytes + alignment, min_block_size, _blocks.empty() ? 0 : _blocks.back().size * 2 } ) );
+                _block = _blocks.size() - 1;
+                _offset = 0;
+            }
+        }
+        void do_deallocate( void * p, std::size_t bytes, std::size_t alignment ) override
+        {
+        }
+        bool do_is_equal( const std::pmr::memory_resource & other ) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        void grow( std::size_t size )
+        {
+            _blocks.push_back( { static_cast<std::byte *>( _upstream->allocate( size, alignof( std::max_align_t ) ) ), size } );
+        }
+        void release()
+        {
+            for ( const auto & it : _blocks )
+                _upstream->deallocate( it.data, it.size, alignof( std::max_align_t ) );
+
+            _blocks.clear();
+            _block = 0;
+            _offset = 0;
+        }
+
+    private:
+        std::size_t _used = 0;
+        std::size_t _block = 0;
+        std::size_t _offset = 0;
+        std::size_t _high_water = 0;
+        std::pmr::memory_resource * _upstream = nullptr;
+        std::pmr::vector<block> _blocks;
+    };
+
+    static constexpr const std::size_t max_damage_rects = 16;
+    static constexpr const std::size_t max_paint_age = 60;
+    static constexpr const std::size_t max_occluders = 32;
+    static constexpr const xui::rect unbounded_clip = { -32768.0f, -32768.0f, 65536.0f, 65536.0f };
+
+    std::size_t hash_bytes( const void * data, std::size_t size, std::size_t seed )
+    {
+        return xui::hash( static_cast<const char *>( data ), size, seed );
+    }
+    template<typename T> std::size_t hash_value( const T & val, std::size_t seed )
+    {
+        return hash_bytes( &val, sizeof( T ), seed );
+    }
+    std::size_t hash_value( const xui::filled & val, std::size_t seed )
+    {
+        seed = hash_value( val.colors.index(), hash_value( val.style, seed ) );
+
+        return std::visit( xui::overload(
+        [&]( std::monostate )
+        {
+            return seed;
+        },
+        [&]( const xui::texture_brush & brush )
+        {
+            return hash_value( brush.mode, xui::hash( brush.image.data(), brush.image.size(), seed ) );
+        },
+        [&]( const auto & color )
+        {
+            return hash_value( color, seed );
+        }
+        ), val.colors );
+    }
+    std::size_t hash_value( const xui::border & val, std::size_t seed )
+    {
+        return hash_value( val.radius, hash_value( val.color, hash_value( val.width, hash_value( val.style, seed ) ) ) );
+    }
+    std::size_t hash_value( const xui::drawlist & list, const xui::drawcmd & cmd, std::size_t paints )
+    {
+        std::size_t seed = hash_value( std::uint32_t( cmd.kind ), hash_value( std::uint32_t( cmd.z ), paints ) );
+
+        list.visit( cmd, xui::overload(
+        [&]( const xui::drawcmd::text_element & element )
+        {
+            seed = hash_value( element.rect, seed );
+            seed = hash_value( element.color, seed );
+            seed = hash_value( element.font, seed );
+            seed = hash_value( element.align, seed );
+            seed = xui::hash( element.text.data(), element.text.size(), seed );
+        },
+        [&]( const xui::drawcmd::path_element & element )
+        {
+            seed = hash_bytes( element.commands.data(), element.commands.size() * sizeof( xui::drawcmd::path_element::command ), seed );
+            seed = hash_bytes( element.points.data(), element.points.size() * sizeof( xui::vec2 ), seed );
+        },
+        [&]( const xui::drawcmd::polygon_element & element )
+        {
+            seed = hash_bytes( element.points.data(), element.points.size() * sizeof( xui::vec2 ), seed );
+        },
+        [&]( const auto & element )
+        {
+            seed = hash_value( element, seed );
+        }
+        ) );
+
+        return seed;
+    }
+
+    bool overlaps( const xui::rect & left, const xui::rect & right )
+    {
+        return left.x <= right.x + right.w && right.x <= left.x + left.w && left.y <= right.y + right.h && right.y <= left.y + left.h;
+    }
+    xui::rect unite( const xui::rect & left, const xui::rect & right )
+    {
+        float x1 = std::min( left.x, right.x );
+        float y1 = std::min( left.y, right.y );
+        float x2 = std::max( left.x + left.w, right.x + right.w );
+        float y2 = std::max( left.y + left.h, right.y + right.h );
+
+        return { x1, y1, x2 - x1, y2 - y1 };
+    }
+    xui::rect intersect( const xui::rect & left, const xui::rect & right )
+    {
+        float x1 = std::max( left.x, right.x );
+        float y1 = std::max( left.y, right.y );
+        float x2 = std::min( left.x + left.w, right.x + right.w );
+        float y2 = std::min( left.y + left.h, right.y + right.h );
+
+        return { x1, y1, std::max( 0.0f, x2 - x1 ), std::max( 0.0f, y2 - y1 ) };
+    }
+    void add_damage( std::pmr::vector<xui::rect> & rects, xui::rect rect )
+    {
+        if ( rect.w <= 0 || rect.h <= 0 )
+            return;
+
+        for ( auto it = rects.begin(); it != rects.end(); )
+        {
+            if ( overlaps( *it, rect ) )
+            {
+                rect = unite( *it, rect );
+                rects.erase( it );
+                it = rects.begin();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        rects.push_back( rect );
+
+        if ( rects.size() > max_damage_rects )
+        {
+            for ( size_t i = 1; i < rects.size(); i++ )
+                rects[0] = unite( rects[0], rects[i] );
+            rects.resize( 1 );
+        }
+    }
+
+    enum layout_kind
+    {
+        LAYOUT_HORIZONTAL,
+        LAYOUT_VERTICAL,
+        LAYOUT_GRID,
+    };
+
+    // plain 4 byte fields only, the whole struct is hashed as bytes
+    struct layout_params
+    {
+        layout_kind kind = LAYOUT_HORIZONTAL;
+        int columns = 1;
+        float spacing = 0;
+        xui::rect rect;
+        xui::layout_wrap wrap = xui::layout_wrap::LAYOUT_NO_WRAP;
+        xui::layout_align justify = xui::layout_align::LAYOUT_START;
+        xui::layout_align align = xui::layout_align::LAYOUT_STRETCH;
+        xui::layout_direction dir = xui::layout_direction::LAYOUT_NORMAL;
+    };
+
+    xui::layout_align layout_align_value( std::uint32_t value, xui::layout_align def )
+    {
+        // "center" parses as ALIGN_CENTER, the other layout names are registered as layout_align
+        if ( value & xui::alignment_flag::ALIGN_CENTER )
+            return xui::layout_align::LAYOUT_CENTER;
+        if ( value == xui::layout_align::LAYOUT_AUTO || value > xui::layout_align::LAYOUT_SPACE_EVENLY )
+            return def;
+
+        return xui::layout_align( value );
+    }
+
+    void arrange_grid( const layout_params & params, std::span<const xui::size> hints, std::span<xui::rect> rects )
+    {
+        const auto & r = params.rect;
+        std::size_t cols = std::max( params.columns, 1 );
+        std::size_t rows = ( hints.size() + cols - 1 ) / cols;
+        float cell_w = std::max( 0.0f, ( r.w - params.spacing * ( cols - 1 ) ) / cols );
+
+        auto row_height = [&]( std::size_t row )
+        {
+            float h = 0;
+            for ( std::size_t i = row * cols; i < std::min( hints.size(), ( row + 1 ) * cols ); i++ )
+                h = std::max( h, hints[i].h );
+            return h;
+        };
+
+        // rows without a height hint share what the others leave over
+        float fixed = 0;
+        std::size_t autos = 0;
+        for ( std::size_t row = 0; row < rows; row++ )
+        {
+            float h = row_height( row );
+            fixed += h;
+            autos += ( h <= 0 );
+        }
+        float auto_h = autos ? std::max( 0.0f, ( r.h - fixed - params.spacing * ( rows - 1 ) ) / autos ) : 0;
+
+        float y = r.y;
+        for ( std::size_t row = 0; row < rows; row++ )
+        {
+            float h = row_height( row );
+            if ( h <= 0 )
+                h = auto_h;
+
+            for ( std::size_t i = row * cols; i < std::min( hints.size(), ( row + 1 ) * cols ); i++ )
+            {
+                std::size_t col = i - row * cols;
+                if ( params.dir == xui::layout_direction::LAYOUT_REVERSE )
+                    col = cols - 1 - col;
+
+                rects[i] = { r.x + col * ( cell_w + params.spacing ), y, cell_w, h };
+            }
+
+            y += h + params.spacing;
+        }
+    }
+
+    void arrange_flex( const layout_params & params, std::span<const int> stretch, std::span<const xui::size> hints, std::span<xui::rect> rects )
+    {
+        bool horz = params.kind == LAYOUT_HORIZONTAL;
+        auto main = [&]( const xui::size & s ) { return horz ? s.w : s.h; };
+        auto cross = [&]( const xui::size & s ) { return horz ? s.h : s.w; };
+        auto grow = [&]( std::size_t i ) { return i < stretch.size() ? std::max( stretch[i], 0 ) : ( main( hints[i] ) <= 0 ? 1 : 0 ); };
+
+        float avail_main = horz ? params.rect.w : params.rect.h;
+        float avail_cross = horz ? params.rect.h : params.rect.w;
+
+        auto line_end = [&]( std::size_t beg )
+        {
+            std::size_t end = beg;
+            float used = 0;
+            for ( ; end < hints.size(); ++end )
+            {
+                float m = main( hints[end] ) + ( end > beg ? params.spacing : 0 );
+                if ( params.wrap != xui::layout_wrap::LAYOUT_NO_WRAP && end > beg && used + m > avail_main )
+                    break;
+                used += m;
+            }
+            return end;
+        };
+        auto line_cross = [&]( std::size_t beg, std::size_t end )
+        {
+            float c = 0;
+            for ( std::size_t i = beg; i < end; i++ )
+                c = std::max( c, cross( hints[i] ) );
+            return c;
+        };
+
+        std::size_t lines = 0;
+        float total_cross = 0;
+        for ( std::size_t beg = 0; beg < hints.size(); beg = line_end( beg ) )
+        {
+            total_cross += line_cross( beg, line_end( beg ) );
+            ++lines;
+        }
+
+        float cross_pos = params.wrap == xui::layout_wrap::LAYOUT_WRAP_REVERSE ? avail_cross : 0;
+        for ( std::size_t beg = 0, end = 0; beg < hints.size(); beg = end )
+        {
+            end = line_end( beg );
+
+            float lc = line_cross( beg, end );
+            if ( params.wrap == xui::layout_wrap::LAYOUT_NO_WRAP )
+                lc = avail_cross;
+            else if ( lc <= 0 )
+                lc = std::max( 0.0f, ( avail_cross - total_cross - params.spacing * ( lines - 1 ) ) / lines );
+
+            if ( params.wrap == xui::layout_wrap::LAYOUT_WRAP_REVERSE )
+                cross_pos -= lc;
+
+            float base = params.spacing * ( end - beg - 1 );
+            int grows = 0;
+            for ( std::size_t i = beg; i < end; i++ )
+            {
+                base += main( hints[i] );
+                grows += grow( i );
+            }
+
+            float free = avail_main - base, start = 0, gap = params.spacing;
+            if ( free > 0 && grows == 0 )
+            {
+                float count = float( end - beg );
+                switch ( params.justify )
+                {
+                case xui::layout_align::LAYOUT_END:
+                    start = free;
+                    break;
+                case xui::layout_align::LAYOUT_CENTER:
+                    start = free / 2;
+                    break;
+                case xui::layout_align::LAYOUT_SPACE_BETWEEN:
+                    gap += count > 1 ? free / ( count - 1 ) : 0;
+                    break;
+                case xui::layout_align::LAYOUT_SPACE_AROUND:
+                    gap += free / count;
+                    start = free / count / 2;
+                    break;
+                case xui::layout_align::LAYOUT_SPACE_EVENLY:
+                    gap += free / ( count + 1 );
+                    start = free / ( count + 1 );
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            float pos = start;
+            for ( std::size_t i = beg; i < end; i++ )
+            {
+                float m = main( hints[i] );
+                if ( free > 0 && grows > 0 )
+                    m += free * grow( i ) / grows;
+                m = std::max( m, 0.0f );
+
+                float c = cross( hints[i] ), offset = 0;
+                if ( c <= 0 || params.align == xui::layout_align::LAYOUT_STRETCH )
+                    c = lc;
+                else if ( params.align == xui::layout_align::LAYOUT_END )
+                    offset = lc - c;
+                else if ( params.align == xui::layout_align::LAYOUT_CENTER )
+                    offset = ( lc - c ) / 2;
+
+                float mp = params.dir == xui::layout_direction::LAYOUT_REVERSE ? avail_main - pos - m : pos;
+                if ( horz )
+                    rects[i] = { params.rect.x + mp, params.rect.y + cross_pos + offset, m, c };
+                else
+                    rects[i] = { params.rect.x + cross_pos + offset, params.rect.y + mp, c, m };
+
+                pos += m + gap;
+            }
+
+            if ( params.wrap == xui::layout_wrap::LAYOUT_WRAP_REVERSE )
+                cross_pos -= params.spacing;
+            else
+                cross_pos += lc + params.spacing;
+        }
+    }
+
+    // a child the layout has not arranged yet is stacked after the previous one until end_layout arranges them all,
+    // a stretch child takes whatever is left of the main axis
+    xui::rect estimate_item( const layout_params & params, std::span<const xui::rect> placed, const xui::size & hint )
+    {
+        const auto & r = params.rect;
+
+        if ( params.kind == LAYOUT_GRID )
+        {
+            std::size_t cols = std::max( params.columns, 1 ), i = placed.size();
+            float cell_w = std::max( 0.0f, ( r.w - params.spacing * ( cols - 1 ) ) / cols );
+            float y = r.y;
+            if ( i >= cols )
+            {
+                const auto & above = placed[i - cols];
+                y = above.y + above.h + params.spacing;
+            }
+
+            return { r.x + ( i % cols ) * ( cell_w + params.spacing ), y, cell_w, hint.h > 0 ? hint.h : cell_w };
+        }
+
+        if ( params.kind == LAYOUT_HORIZONTAL )
+        {
+            float x = placed.empty() ? r.x : placed.back().x + placed.back().w + params.spacing;
+            return { x, r.y, hint.w > 0 ? hint.w : std::max( r.x + r.w - x, 0.0f ), r.h };
+        }
+
+        float y = placed.empty() ? r.y : placed.back().y + placed.back().h + params.spacing;
+        return { r.x, y, r.w, hint.h > 0 ? hint.h : std::max( r.y + r.h - y, 0.0f ) };
+    }
+
+    // roles menu() and menu_item() read from a batch, in column order
+    constexpr int menu_roles[] = { xui::menu_model::ID, xui::menu_model::ICON, xui::menu_model::NAME, xui::menu_model::IS_MENU, xui::menu_model::IS_SELECTED };
+}
 
 xui::vec2 xui::rect::center() const
 {
@@ -54,6 +614,45 @@ bool xui::rect::contains( const xui::vec2 & p ) const
     return ( p.x > x && p.x < ( x + w ) ) && ( p.y > y && p.y < ( y + h ) );
 }
 
+xui::control_id::control_id( std::string_view name )
+    : _hash( name.empty() ? 0 : xui::hash( name ) )
+{
+#ifndef NDEBUG
+    if ( _hash != 0 ) control_names::instance().insert( _hash, 0, name );
+#endif
+}
+
+xui::control_id xui::control_id::child( std::size_t index ) const
+{
+    xui::control_id result( xui::hash( reinterpret_cast<const char *>( &index ), sizeof( index ), _hash ) );
+
+#ifndef NDEBUG
+    control_names::instance().insert( result._hash, _hash, index );
+#endif
+
+    return result;
+}
+
+xui::control_id xui::control_id::child( std::string_view name ) const
+{
+    xui::control_id result( xui::hash( name.data(), name.size(), xui::hash( "/", 1, _hash ) ) );
+
+#ifndef NDEBUG
+    control_names::instance().insert( result._hash, _hash, name );
+#endif
+
+    return result;
+}
+
+std::string xui::control_id::name() const
+{
+#ifndef NDEBUG
+    return control_names::instance().find( _hash );
+#else
+    return {};
+#endif
+}
+
 xui::url::url( url && val )
     : string_type( val )
 {
@@ -357,14 +956,14 @@ xui::color xui::color::lerp( const xui::color & target, float t ) const
 
 
 xui::style::style( std::pmr::memory_resource * res )
-    : _selectors( res )
+    : _atoms( res ), _table( res ), _values( res ), _cache( res )
 {
 
 }
 
 bool xui::style::parse( std::string_view str )
 {
-    _selectors.clear();
+    std::pmr::map<std::string, selector> selectors( _values.get_allocator().resource() );
 
     bool result = true;
     std::string name;
@@ -379,7 +978,7 @@ bool xui::style::parse( std::string_view str )
         }
         else if ( *beg == '{' )
         {
-            _selectors.insert( { name, parse_selector( beg, end ) } );
+            selectors.insert( { name, parse_selector( beg, end ) } );
             name.clear();
         }
         else if ( *beg == ',' )
@@ -392,20 +991,24 @@ bool xui::style::parse( std::string_view str )
         }
     }
 
+    compile( selectors );
+
     return result;
 }
 
 xui::style::variant xui::style::find( std::string_view name ) const
 {
     // {id}#{type}-{element}-{element}-{element}:{action}@{attr}
-    std::string_view type, action, id, attr;
-    std::pmr::vector<std::string_view> elements( _selectors.get_allocator().resource() );
-
+    std::size_t id = 0;
+    std::string_view type, action, attr;
+    std::array<std::byte, 256> buffer;
+    std::pmr::monotonic_buffer_resource res( buffer.data(), buffer.size() );
+    std::pmr::vector<std::string_view> elements( &res );
 
     // {id}
     if ( name.find( '#' ) != std::string_view::npos )
     {
-        id = { name.begin(), name.begin() + name.find( '#' ) + 1 };
+        id = xui::hash( name.data(), name.find( '#' ) );
         name = { name.begin() + name.find( '#' ) + 1, name.end() };
     }
     // {attr}
@@ -417,13 +1020,13 @@ xui::style::variant xui::style::find( std::string_view name ) const
     // {action}
     if ( name.find( ':' ) != std::string_view::npos )
     {
-        action = { name.begin() + name.find( ':' ), name.end() };
+        action = { name.begin() + name.find( ':' ) + 1, name.end() };
         name = { name.begin(), name.begin() + name.find( ':' ) };
     }
     // {element}
     while ( name.find( '-' ) != std::string_view::npos )
     {
-        elements.insert( elements.begin(), { name.begin() + name.find_last_of( '-' ), name.end() } );
+        elements.insert( elements.begin(), { name.begin() + name.find_last_of( '-' ) + 1, name.end() } );
         name = { name.begin(), name.begin() + name.find_last_of( '-' ) };
     }
     // {type}
@@ -432,87 +1035,127 @@ xui::style::variant xui::style::find( std::string_view name ) const
         type = name;
     }
 
-    std::optional<xui::style::variant> opt;
+    return find( id, type, elements, action, attr );
+}
+
+xui::style::variant xui::style::find( std::size_t id, std::string_view type, std::span<const std::string_view> elements, std::string_view status, std::string_view attr ) const
+{
+    auto attr_atom = atom( xui::hash( attr ) );
+    if ( attr_atom == std::numeric_limits<std::uint32_t>::max() )
+        return {};
+
+    auto selector = [&]( std::size_t seed, std::size_t count, bool action )
+    {
+        seed = xui::hash( type.data(), type.size(), seed );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            seed = xui::hash( "-", 1, seed );
+            seed = xui::hash( elements[i].data(), elements[i].size(), seed );
+        }
+        if ( action && !status.empty() )
+        {
+            seed = xui::hash( ":", 1, seed );
+            seed = xui::hash( status.data(), status.size(), seed );
+        }
+        return seed;
+    };
 
     // {id}#{type}-{element}-{element}-{element}:{action}@{attr}
-    opt = find( std::format( "{}{}{}{}", id, type, std::span<std::string_view>{ elements }, action ), attr );
-    if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
+    if ( id != 0 )
     {
-        return opt.value();
+        if ( auto val = lookup( selector( xui::hash( "#", 1, id ), elements.size(), true ), attr_atom ) )
+            return *val;
     }
 
     // {type}-{element}-{element}-{element}:{action}@{attr}
-    opt = find( std::format( "{}{}{}", type, std::span<std::string_view>{ elements }, action ), attr );
-    if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
-    {
-        return opt.value();
-    }
+    if ( auto val = lookup( selector( xui::hash( "" ), elements.size(), true ), attr_atom ) )
+        return *val;
 
     // {type}-{element}-{element}-{element}@{attr}
-    opt = find( std::format( "{}{}", type, std::span<std::string_view>{ elements } ), attr );
-    if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
-    {
-        return opt.value();
-    }
-
     // {type}-{element}-{element}@{attr}
     // {type}-{element}@{attr}
-    if ( !elements.empty() )
+    // {type}@{attr}
+    for ( std::size_t i = elements.size() + 1; i-- != 0; )
     {
-        auto beg = elements.begin();
-        auto end = elements.end();
-
-        while ( beg != end )
-        {
-            opt = find( std::format( "{}{}", type, std::span<std::string_view>{ beg, end } ), attr );
-            if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
-            {
-                return opt.value();
-            }
-
-            --end;
-        }
-    }
-
-    // {type}@{attr}
-    opt = find( { type.begin(), type.end() }, attr );
-    if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
-    {
-        return opt.value();
-    }
+        if ( auto val = lookup( selector( xui::hash( "" ), i, false ), attr_atom ) )
+            return *val;
+    }
 
     // *@{attr}
-    opt = find( "*", attr );
-    if ( opt.has_value() && opt.value().index() != variant::inherit_idx )
-    {
-        return opt.value();
-    }
-
+    if ( auto val = lookup( xui::hash( "*" ), attr_atom ) )
+        return *val;
 
     return {};
 }
 
-std::optional<xui::style::variant> xui::style::find( std::string_view type, std::string_view attr ) const
+void xui::style::compile( const std::pmr::map<std::string, selector> & selectors )
 {
-    auto it = _selectors.find( { type.begin(), type.end() } );
-    if ( it != _selectors.end() )
+    std::size_t count = 0;
+    for ( const auto & it : selectors )
+        count += it.second.attrs.size();
+
+    _cache.clear();
+    _values.clear();
+    _atom_count = 0;
+    _atoms.assign( std::bit_ceil( ( selectors.size() + count ) * 2 + 1 ), {} );
+    _table.assign( std::bit_ceil( count * 2 + 1 ), {} );
+    _values.reserve( count );
+
+    for ( const auto & it : selectors )
     {
-        auto it2 = it->second.attrs.find( { attr.begin(), attr.end() } );
-        if ( it2 != it->second.attrs.end() )
+        std::uint64_t selector = intern( xui::hash( it.first ) );
+
+        for ( const auto & attr : it.second.attrs )
         {
-            if ( it2->second.index() == xui::style::variant::inherit_idx )
+            std::uint64_t key = ( selector << 32 ) | intern( xui::hash( attr.first ) );
+
+            auto & slot = probe( _table, key );
+            if ( slot.value == std::numeric_limits<std::uint32_t>::max() )
             {
-                int i = 0;
+                slot.key = key;
+                slot.value = static_cast<std::uint32_t>( _values.size() );
+                _values.push_back( attr.second );
             }
-            return it2->second;
         }
     }
-    return {};
+}
+
+std::uint32_t xui::style::atom( std::size_t name ) const
+{
+    if ( _atoms.empty() )
+        return std::numeric_limits<std::uint32_t>::max();
+
+    return probe( _atoms, name ).value;
+}
+
+std::uint32_t xui::style::intern( std::size_t name )
+{
+    auto & slot = probe( _atoms, name );
+    if ( slot.value == std::numeric_limits<std::uint32_t>::max() )
+    {
+        slot.key = name;
+        slot.value = _atom_count++;
+    }
+    return slot.value;
+}
+
+const xui::style::variant * xui::style::lookup( std::size_t selector, std::uint32_t attr ) const
+{
+    auto selector_atom = atom( selector );
+    if ( selector_atom == std::numeric_limits<std::uint32_t>::max() )
+        return nullptr;
+
+    const auto & slot = probe( _table, ( std::uint64_t( selector_atom ) << 32 ) | attr );
+    if ( slot.value == std::numeric_limits<std::uint32_t>::max() || _values[slot.value].index() == xui::style::variant::inherit_idx )
+        return nullptr;
+
+    return &_values[slot.value];
 }
 
 xui::style::selector xui::style::parse_selector( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '{' && "" );
+    assert( *beg == '{' );
+    ++beg;
 
     std::string name;
     xui::style::selector select;
@@ -615,21 +1258,24 @@ xui::style::variant xui::style::parse_attribute( std::string_view::iterator & be
 
 xui::color xui::style::parse_light( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     return parse_attribute( beg, end ).value<xui::color>().light();
 }
 
 xui::color xui::style::parse_dark( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     return parse_attribute( beg, end ).value<xui::color>().dark();
 }
 
 xui::color xui::style::parse_rgba( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::color result;
 
@@ -643,7 +1289,8 @@ xui::color xui::style::parse_rgba( std::string_view::iterator & beg, std::string
 
 xui::color xui::style::parse_rgb( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::color result;
 
@@ -656,7 +1303,8 @@ xui::color xui::style::parse_rgb( std::string_view::iterator & beg, std::string_
 
 xui::vec2 xui::style::parse_vec2( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::vec2 result;
 
@@ -668,7 +1316,8 @@ xui::vec2 xui::style::parse_vec2( std::string_view::iterator & beg, std::string_
 
 xui::vec4 xui::style::parse_vec4( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::vec4 result;
 
@@ -682,14 +1331,15 @@ xui::vec4 xui::style::parse_vec4( std::string_view::iterator & beg, std::string_
 
 xui::color xui::style::parse_hex( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '#' && "" );
+    assert( *beg == '#' );
+    ++beg;
 
     xui::color color;
 
     auto it = beg;
     while ( *it != ';' ) ++it;
 
-    std::from_chars( beg.operator->(), it.operator->(), color.hex, 16 );
+    std::from_chars( std::to_address( beg ), std::to_address( it ), color.hex, 16 );
     beg = it;
 
     return color;
@@ -697,7 +1347,8 @@ xui::color xui::style::parse_hex( std::string_view::iterator & beg, std::string_
 
 xui::url xui::style::parse_url( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     std::string result;
 
@@ -716,7 +1367,8 @@ xui::url xui::style::parse_url( std::string_view::iterator & beg, std::string_vi
 
 xui::hatch_color xui::style::parse_hatch( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::hatch_color result;
 
@@ -728,7 +1380,8 @@ xui::hatch_color xui::style::parse_hatch( std::string_view::iterator & beg, std:
 
 xui::texture_brush xui::style::parse_sample( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::texture_brush result;
 
@@ -740,7 +1393,8 @@ xui::texture_brush xui::style::parse_sample( std::string_view::iterator & beg, s
 
 xui::linear_gradient xui::style::parse_linear( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::linear_gradient result;
 
@@ -754,7 +1408,8 @@ xui::linear_gradient xui::style::parse_linear( std::string_view::iterator & beg,
 
 xui::stroke xui::style::parse_stroke( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::stroke result;
 
@@ -767,7 +1422,8 @@ xui::stroke xui::style::parse_stroke( std::string_view::iterator & beg, std::str
 
 xui::border xui::style::parse_border( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::border result;
 
@@ -781,7 +1437,8 @@ xui::border xui::style::parse_border( std::string_view::iterator & beg, std::str
 
 xui::filled xui::style::parse_filled( std::string_view::iterator & beg, std::string_view::iterator end )
 {
-    _ASSERT( *beg++ == '(' && "" );
+    assert( *beg == '(' );
+    ++beg;
 
     xui::filled result;
 
@@ -894,6 +1551,17 @@ std::map<std::string_view, std::uint32_t> & xui::style::flags()
         { "right to left", (std::uint32_t)xui::direction::RIGHT_LEFT },
         { "top to bottom", (std::uint32_t)xui::direction::TOP_BOTTOM },
         { "bottom to top", (std::uint32_t)xui::direction::BOTTOM_TOP },
+
+        // layout, "center" is shared with alignment
+        { "nowrap", xui::layout_wrap::LAYOUT_NO_WRAP },
+        { "wrap", xui::layout_wrap::LAYOUT_WRAP },
+        { "wrap-reverse", xui::layout_wrap::LAYOUT_WRAP_REVERSE },
+        { "stretch", xui::layout_align::LAYOUT_STRETCH },
+        { "start", xui::layout_align::LAYOUT_START },
+        { "end", xui::layout_align::LAYOUT_END },
+        { "space-between", xui::layout_align::LAYOUT_SPACE_BETWEEN },
+        { "space-around", xui::layout_align::LAYOUT_SPACE_AROUND },
+        { "space-evenly", xui::layout_align::LAYOUT_SPACE_EVENLY },
     };
     return style_flags;
 }
@@ -1065,14 +1733,175 @@ std::map<std::string_view, std::function<xui::style::variant( std::string_view::
 
 
 
+xui::drawcmd::path_element & xui::drawcmd::path_element::from_svg( std::string_view data )
+{
+    auto beg = data.data();
+    auto end = data.data() + data.size();
+
+    auto number = [&]()
+    {
+        while ( beg != end && ( std::isspace( *beg ) || *beg == ',' ) ) ++beg;
+
+        float value = 0;
+        beg = std::from_chars( beg, end, value ).ptr;
+        return value;
+    };
+    auto point = [&]()
+    {
+        xui::vec2 p;
+
+        p.x = number();
+        p.y = number();
+
+        return p;
+    };
+
+    while ( beg != end )
+    {
+        switch ( *beg++ )
+        {
+        case 'M':
+            moveto( point() );
+            break;
+        case 'L':
+            lineto( point() );
+            break;
+        case 'C':
+        {
+            auto c1 = point();
+            auto c2 = point();
+            curveto( c1, c2, point() );
+        }
+        break;
+        case 'S':
+        {
+            auto c = point();
+            smooth_curveto( c, point() );
+        }
+        break;
+        case 'Q':
+        {
+            auto c = point();
+            quadratic_belzier_curve( c, point() );
+        }
+        break;
+        case 'T':
+            smooth_quadratic_belzier_curveto( point() );
+            break;
+        case 'Z':
+            closepath();
+            break;
+        default:
+            break;
+        }
+    }
+
+    return *this;
+}
+
+std::string xui::drawcmd::path_element::to_svg() const
+{
+    std::string result;
+
+    auto it = points.begin();
+    for ( auto cmd : commands )
+    {
+        result.push_back( "MLCSQTZ"[cmd] );
+
+        for ( std::size_t i = 0; i < point_count( cmd ); ++i, ++it )
+            result.append( std::format( "{} {} ", it->x, it->y ) );
+
+        if ( cmd == CLOSEPATH )
+            result.push_back( ' ' );
+    }
+
+    return result;
+}
+
+
+
+xui::rect xui::drawlist::measure( const xui::drawcmd & cmd ) const
+{
+    float inflate = 1.0f;
+    xui::vec2 min = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    xui::vec2 max = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+    auto expand = [&]( const xui::vec2 & p )
+    {
+        min.x = std::min( min.x, p.x );
+        min.y = std::min( min.y, p.y );
+        max.x = std::max( max.x, p.x );
+        max.y = std::max( max.y, p.y );
+    };
+    auto expand_rect = [&]( const xui::rect & rect )
+    {
+        expand( { rect.x, rect.y } );
+        expand( { rect.x + rect.w, rect.y + rect.h } );
+    };
+
+    visit( cmd, xui::overload(
+    [&]( const xui::drawcmd::text_element & element )
+    {
+        expand_rect( element.rect );
+    },
+    [&]( const xui::drawcmd::line_element & element )
+    {
+        expand( element.p1 );
+        expand( element.p2 );
+        inflate += stroke( cmd ).width / 2;
+    },
+    [&]( const xui::drawcmd::rect_element & element )
+    {
+        expand_rect( element.rect );
+        inflate += stroke( cmd ).width / 2;
+    },
+    [&]( const xui::drawcmd::path_element & element )
+    {
+        for ( const auto & it : element.points )
+            expand( it );
+        inflate += stroke( cmd ).width / 2;
+    },
+    [&]( const xui::drawcmd::image_element & element )
+    {
+        expand_rect( element.rect );
+    },
+    [&]( const xui::drawcmd::circle_element & element )
+    {
+        expand( element.center - element.radius );
+        expand( element.center + element.radius );
+        inflate += stroke( cmd ).width / 2;
+    },
+    [&]( const xui::drawcmd::ellipse_element & element )
+    {
+        expand( element.center - element.radius );
+        expand( element.center + element.radius );
+        inflate += stroke( cmd ).width / 2;
+    },
+    [&]( const xui::drawcmd::polygon_element & element )
+    {
+        for ( const auto & it : element.points )
+            expand( it );
+        inflate += stroke( cmd ).width / 2;
+    }
+    ) );
+
+    if ( min.x > max.x || min.y > max.y )
+        return {};
+
+    min.x = std::floor( min.x - inflate );
+    min.y = std::floor( min.y - inflate );
+    max.x = std::ceil( max.x + inflate );
+    max.y = std::ceil( max.y + inflate );
 
+    return { min.x, min.y, max.x - min.x, max.y - min.y };
+}
 
 struct xui::context::private_p
 {
 public:
     private_p( std::pmr::memory_resource * res )
         : _res( res )
-        , _commands( res )
+        , _frames{ res, res }
         , _disables( res )
         , _zlevels( res )
         , _types( res )
@@ -1080,11 +1909,38 @@ public:
         , _ctl_ids( res )
         , _styles( res )
         , _viewports( res )
+        , _clips( res )
         , _windows( res )
         , _textures( res )
         , _act_ctl_id( res )
         , _hot_ctl_id( res )
+        , _text_sizes( res )
+        , _text_index( res )
+        , _layouts( res )
+        , _layout_caches( res )
+        , _itemviews( res )
+        , _itemview_states( res )
+        , _tableviews( res )
+        , _batches( res )
+        , _menu_geometries( res )
+        , _strokes( res )
+        , _fills( res )
+        , _paint_states( res )
+        , _free_paints( res )
+        , _paint_index( res )
+        , _occluders( res )
+        , _regions( res )
+        , _region_scopes( res )
+        , _layers( res )
+        , _layer_scopes( res )
+        , _layer_damages( res )
     {
+        // paint 0 is the default stroke and fill of commands that have none, it is never evicted
+        _strokes.emplace_back();
+        _fills.emplace_back();
+        _paint_states.push_back( { true, 0, 0 } );
+        _paint_index[hash_value( xui::border(), xui::hash( "stroke" ) )] = 0;
+        _paint_index[hash_value( xui::filled(), xui::hash( "filled" ) )] = 0;
     }
 
 public:
@@ -1093,1717 +1949,3955 @@ public:
     std::pmr::memory_resource * _res = nullptr;
 
 public:
-    std::pmr::vector<xui::drawcmd> _commands;
+    template<typename T> T & push( xui::window_id id, size_t z, xui::drawcmd::element_kind kind, std::pmr::vector<T> & payloads, T && element, xui::paint_id stroke = 0, xui::paint_id fill = 0 )
+    {
+        xui::drawcmd cmd;
+
+        cmd.id = id;
+        cmd.z = z;
+        cmd.kind = kind;
+        cmd.index = static_cast<std::uint32_t>( payloads.size() );
+        cmd.stroke = stroke;
+        cmd.fill = fill;
+        cmd.clip = _clips.empty() ? 0 : _clips.back();
+
+        _frame->list.commands.push_back( cmd );
+        payloads.push_back( std::move( element ) );
+
+        return payloads.back();
+    }
+    template<typename T> T * copy( std::span<const T> data )
+    {
+        auto result = static_cast<T *>( _frame->arena.allocate( data.size() * sizeof( T ), alignof( T ) ) );
+
+        std::uninitialized_copy( data.begin(), data.end(), result );
+
+        return result;
+    }
+
+public:
+    struct damage
+    {
+        xui::window_id id;
+        std::pmr::vector<xui::rect> rects;
+    };
+    struct frame_data
+    {
+        frame_data( std::pmr::memory_resource * res )
+            : arena( res ), list( &arena ), hashes( &arena ), damages( &arena ), inputs( &arena ), recorded( &arena )
+        {
+        }
+
+        // the containers are rebuilt after the reset, some standard libraries allocate from the arena on construction
+        void clear()
+        {
+            std::destroy_at( &recorded );
+            std::destroy_at( &inputs );
+            std::destroy_at( &damages );
+            std::destroy_at( &hashes );
+            std::destroy_at( &list );
+
+            arena.reset();
+            if ( pending_reserve != 0 )
+            {
+                arena.reserve( pending_reserve );
+                pending_reserve = 0;
+            }
+
+            std::construct_at( &list, &arena );
+            std::construct_at( &hashes, &arena );
+            std::construct_at( &damages, &arena );
+            std::construct_at( &inputs, &arena );
+            std::construct_at( &recorded, &arena );
+        }
+        void reserve( const frame_data & last )
+        {
+            // sized from the previous frame so the arena does not keep the abandoned halves of doubling vectors
+            list.commands.reserve( last.list.commands.size() );
+            list.texts.reserve( last.list.texts.size() );
+            list.lines.reserve( last.list.lines.size() );
+            list.rects.reserve( last.list.rects.size() );
+            list.paths.reserve( last.list.paths.size() );
+            list.images.reserve( last.list.images.size() );
+            list.circles.reserve( last.list.circles.size() );
+            list.ellipses.reserve( last.list.ellipses.size() );
+            list.polygons.reserve( last.list.polygons.size() );
+            list.clips.reserve( last.list.clips.size() );
+            recorded.reserve( last.recorded.size() );
+        }
+
+        std::size_t pending_reserve = 0;
+        frame_resource arena;
+        xui::drawlist list;
+        std::pmr::vector<std::size_t> hashes;
+        std::pmr::vector<damage> damages;
+        std::pmr::map<xui::window_id, xui::input_state> inputs;
+        // headers of the cached regions in recording order, their payloads stay in list
+        std::pmr::vector<xui::drawcmd> recorded;
+    };
+
+public:
+    frame_data _frames[2];
+    frame_data * _frame = &_frames[0];
+    frame_data * _last_frame = &_frames[1];
 
 public:
-    size_t _zvalue = 0;
     size_t _ctl_id_idx = 0;
     std::pmr::deque<bool> _disables;
     std::pmr::deque<size_t> _zlevels;
     std::pmr::deque<style_type> _types;
     std::pmr::deque<xui::font_id> _fonts;
-    std::pmr::deque<std::string> _ctl_ids;
+    std::pmr::deque<xui::control_id> _ctl_ids;
     std::pmr::deque<xui::style *> _styles;
     std::pmr::deque<xui::rect> _viewports;
+    std::pmr::deque<std::uint32_t> _clips;
     std::pmr::deque<xui::window_id> _windows;
     std::pmr::deque<xui::texture_id> _textures;
-    std::pmr::map<xui::window_id, std::string> _act_ctl_id;
-    std::pmr::map<xui::window_id, std::string> _hot_ctl_id;
-};
+    std::pmr::map<xui::window_id, xui::control_id> _act_ctl_id;
+    std::pmr::map<xui::window_id, xui::control_id> _hot_ctl_id;
 
-xui::context::context( std::pmr::memory_resource * res )
-    : _p( new ( res->allocate( sizeof( private_p ) ) ) private_p( res ) )
-{
-}
+public:
+    struct layout_cache
+    {
+        layout_cache( std::pmr::memory_resource * res )
+            : stretch( res ), hints( res ), rects( res )
+        {
+        }
 
-xui::context::~context()
-{
-    auto res = _p->_commands.get_allocator().resource();
+        bool used = false;
+        bool dirty = true;
+        std::size_t key = 0;
+        layout_params params;
+        std::pmr::vector<int> stretch;
+        std::pmr::vector<xui::size> hints;
+        std::pmr::vector<xui::rect> rects;
+    };
+    struct layout_state
+    {
+        layout_kind kind;
+        layout_cache * cache;
+        std::size_t count;
+    };
 
-    _p->~private_p();
+    // child rects are only recomputed when the constraints or a child size hint change
+    void begin_layout( xui::control_id ctl_id, const layout_params & params, std::span<const int> stretch )
+    {
+        auto it = _layout_caches.find( ctl_id.hash() );
+        if ( it == _layout_caches.end() )
+            it = _layout_caches.emplace( ctl_id.hash(), layout_cache( _res ) ).first;
 
-    res->deallocate( _p, sizeof( private_p ) );
-}
+        auto & cache = it->second;
+        auto key = hash_bytes( stretch.data(), stretch.size() * sizeof( int ), hash_value( params, xui::hash( "layout" ) ) );
+        if ( cache.key != key )
+        {
+            cache.key = key;
+            cache.params = params;
+            cache.stretch.assign( stretch.begin(), stretch.end() );
+            cache.dirty = true;
+        }
 
-std::string_view xui::context::dark_style()
-{
-    return
-        R"(
-    *{
-        font-color: white;
-        text-align: center;
+        use( cache.used );
+        _layouts.push_back( { params.kind, &cache, 0 } );
+    }
+    // new constraints are arranged once with last frame's hints, hint changes wait for end_layout
+    xui::rect next_layout_item( const xui::size & hint )
+    {
+        auto & state = _layouts.back();
+        auto & cache = *state.cache;
+        auto i = state.count++;
 
-        margin: vec4( 0, 0, 0, 0 );
-        padding: vec4( 0, 0, 0, 0 );
+        if ( i == 0 && cache.dirty )
+            arrange( cache );
 
-        filled: filled( solid, black );
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-    },
-    window{
-        border: border( solid, 1, transparent, vec4( 10, 10, 10, 10 ) );
-        filled: filled( solid, black );
-    },
-    window-resize{
-        stroke: stroke( solid, 1, white );
-        filled: filled( dense2, hatch( white, transparent ) );
-    },
-    window-titlebar{
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-        border: border( solid, 1, transparent, vec4( 10, 10, 0, 0 ) );
-    },
-    window-titlebar-title{
-        font-color: white;
-        text-align: left vcenter;
-    },
-    window-titlebar-closebox{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    window-titlebar-closebox:hover{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
-        filled: filled( solid, red );
-    },
-    window-titlebar-closebox:disable{
-        stroke: stroke( solid, 1, darkgray );
-        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    window-titlebar-minimizebox{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    window-titlebar-minimizebox:hover{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 94, 92, 91 ) );
-    },
-    window-titlebar-minimizebox:disable{
-        stroke: stroke( solid, 1, darkgray );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    window-titlebar-maximizebox{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    window-titlebar-maximizebox:hover{
-        stroke: stroke( solid, 1, white );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 94, 92, 91 ) );
-    },
-    window-titlebar-maximizebox:disable{
-        stroke: stroke( solid, 1, darkgray );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    menubar{
-        font-color: white;
-        text-align: center;
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-    },
-    menubar:hover{
-        filled: filled( solid, green );
-    },
-    menubar:active{
-        filled: filled( solid, darkgray );
-    },
-    menubar-menu{
-        filled: filled( solid, rgb( 76, 74, 72 ) );
-    },
-    menubar-menu-item{
-    },
-    menubar-menu-item:hover{
-        filled: filled( solid, green );
-    },
-    menubar-menu-item:active{
-        filled: filled( solid, darkgray );
-    },
-    label{
-        font-color: green;
-    },
-    image{
-    },
-    slider{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, white );
-        direction: bottom to top;
-    },
-    slider:hover{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, green );
-    },
-    slider:active{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, yellow );
-    },
-    slider-cursor{
-        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, red );
-    },
-    process{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, rgb( 94, 92, 91 ) );
-    },
-    process-text{
-        font-color: white;
-    },
-    process-cursor{
-        border-color: transparent;
-        filled: filled( solid, red );
-        direction: left to right;
-    },
-    button{
-        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
-        filled: filled( solid, white );
-    },
-    button:hover{
-        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
-        filled: filled( solid, red );
-    },
-    button:active{
-        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
-        filled: filled( solid, green );
-    },
-    button-text{
-        font-color: black;
-        text-align: right top;
-    },
-    button-text:hover{
-        font-color: white;
-    },
-    button-text:active{
-        font-color: red;
-    },
-    radio{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, blue );
-    },
-    radio:hover{
-        filled: filled( solid, light( blue ) );
-    },
-    radio:active{
-        filled: filled( solid, green );
-    },
-    radio-indicator{
-        filled: filled( solid, white );
-    },
-    check{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, blue );
-    },
-    check:hover{
-        filled: filled( solid, light( blue ) );
-    },
-    check:active{
-        filled: filled( solid, green );
-    },
-    check-indicator{
-        stroke: stroke( solid, 3, white );
-    },
-    scrollbar{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, green );
-    },
-    scrollbar-cursor{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, red );
-    },
-    scrollbar-arrow{
-        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
-        filled: filled( solid, blue );
-        stroke: stroke( solid, 3, white );
-    },
-    combobox{
-    },
-    combobox-list{
-    },
-    tabview{
-    },
-    tabview-tab{
-    },
-    listview{
-    },
-    listview-item{
-    },
-    treeview{
-    },
-    treeview-item{
-    },
-    tableview{
-    },
-    tableview-header{
-    },
-    tableview-item{
-    }
-)";
-}
-
-std::string_view xui::context::light_style()
-{
-    return "";
-}
-
-void xui::context::init( xui::implement * impl )
-{
-    _p->_impl = impl;
-}
-
-void xui::context::release()
-{
-    _p->_impl = nullptr;
-}
+        if ( i >= cache.hints.size() )
+        {
+            cache.rects.resize( i );
+            cache.rects.push_back( estimate_item( cache.params, cache.rects, hint ) );
+            cache.hints.resize( i + 1 );
+            cache.hints[i] = hint;
+            cache.dirty = true;
+        }
+        else if ( cache.hints[i].w != hint.w || cache.hints[i].h != hint.h )
+        {
+            cache.hints[i] = hint;
+            cache.dirty = true;
+        }
 
-void xui::context::set_scale( float factor )
-{
-    _p->_factor = factor;
-}
+        return cache.rects[i];
+    }
+    void end_layout()
+    {
+        auto & state = _layouts.back();
+        auto & cache = *state.cache;
+        if ( state.count != cache.hints.size() )
+        {
+            cache.hints.resize( state.count );
+            cache.dirty = true;
+        }
 
-void xui::context::push_style( xui::style * style )
-{
-    _p->_styles.emplace_back( style );
-}
+        if ( cache.dirty )
+        {
+            std::pmr::vector<xui::rect> handed( cache.rects.begin(), cache.rects.begin() + std::min( state.count, cache.rects.size() ), &_frame->arena );
 
-void xui::context::pop_style()
-{
-    _p->_styles.pop_back();
-}
+            arrange( cache );
 
-std::string xui::context::current_style_name() const
-{
-    std::string result;
+            // children already drew at the estimates, recordings holding them must not be replayed
+            for ( std::size_t i = 0; i < handed.size(); ++i )
+            {
+                const auto & a = handed[i], & b = cache.rects[i];
+                if ( a.x != b.x || a.y != b.y || a.w != b.w || a.h != b.h )
+                {
+                    for ( auto & it : _region_scopes ) it.stale = true;
+                    for ( auto & it : _layer_scopes ) it.stale = true;
+                    break;
+                }
+            }
+        }
 
-    if ( !_p->_ctl_ids.empty() )
-    {
-        result.append( _p->_ctl_ids.back() );
-        result.append( "#" );
+        _layouts.pop_back();
     }
-
-    result.append( _p->_types.back().type.begin(), _p->_types.back().type.end() );
-
-    for ( const auto & it : _p->_types.back().elements )
+    void arrange( layout_cache & cache )
     {
-        result.append( "-" );
-        result.append( it );
+        cache.rects.resize( cache.hints.size() );
+        if ( cache.params.kind == LAYOUT_GRID )
+            arrange_grid( cache.params, cache.hints, cache.rects );
+        else
+            arrange_flex( cache.params, cache.stretch, cache.hints, cache.rects );
+        cache.dirty = false;
     }
 
-    if ( !_p->_types.back().status.empty() )
+public:
+    // captured on first use in a frame, so every widget of the frame sees the same input
+    const xui::input_state & input( xui::window_id id )
     {
-        if ( _p->_types.back().status.back() != xui::event_status::NORMAL )
+        auto & inputs = _frame->inputs;
+
+        auto it = inputs.find( id );
+        if ( it == inputs.end() )
         {
-            result.append( ":" );
+            xui::input_state state( &_frame->arena );
 
-            switch ( _p->_types.back().status.back() )
+            if ( _impl != nullptr && id != xui::invalid_window_id )
             {
-            case xui::DRAG: result.append( "drag" ); break;
-            case xui::HOVER: result.append( "hover" ); break;
-            case xui::ACTIVE: result.append( "active" ); break;
-            case xui::DISABLED: result.append( "disabled" ); break;
+                state.rect = _impl->get_window_rect( id );
+                state.status = _impl->get_window_status( id );
+                state.cursor_pos = _impl->get_cursor_pos( id );
+                state.cursor_dt = _impl->get_cursor_dt( id );
+                state.wheel = _impl->get_cusor_wheel( id );
+                state.unicodes = _impl->get_unicodes( id );
+
+                auto touchs = _impl->get_touchs( id );
+                state.touchs.assign( touchs.begin(), touchs.end() );
+
+                for ( int i = 0; i < xui::event::EVENT_MAX_COUNT; i++ )
+                    state.events.set( i, _impl->get_event( id, xui::event( i ) ) != 0 );
             }
+
+            it = inputs.emplace( id, std::move( state ) ).first;
         }
+
+        return it->second;
     }
 
-    return result;
-}
+public:
+    xui::size font_size( xui::font_id id, std::string_view text )
+    {
+        auto key = hash_value( _factor, hash_value( id, xui::hash( text ) ) );
 
-xui::style::variant xui::context::current_style( std::string_view attr ) const
-{
-    std::string name = current_style_name();
+        auto it = _text_index.find( key );
+        if ( it != _text_index.end() && it->second->font == id && it->second->factor == _factor && it->second->text == text )
+        {
+            ++_text_hits;
+            _text_sizes.splice( _text_sizes.begin(), _text_sizes, it->second );
+            return it->second->size;
+        }
 
-    name.append( "@" );
-    name.append( attr );
+        ++_text_misses;
+        auto size = _impl->font_size( id, text );
 
-    for ( auto it = _p->_styles.rbegin(); it != _p->_styles.rend(); ++it )
+        if ( it != _text_index.end() )
+        {
+            // hash collision, the newer string takes over the slot
+            *it->second = { key, id, _factor, std::pmr::string( text, _res ), size };
+            _text_sizes.splice( _text_sizes.begin(), _text_sizes, it->second );
+            return size;
+        }
+
+        trim_text_sizes( _text_capacity > 0 ? _text_capacity - 1 : 0 );
+        if ( _text_capacity > 0 )
+        {
+            _text_sizes.push_front( { key, id, _factor, std::pmr::string( text, _res ), size } );
+            _text_index.emplace( key, _text_sizes.begin() );
+        }
+
+        return size;
+    }
+    void trim_text_sizes( std::size_t count )
     {
-        auto val = ( *it )->find( name );
-        if ( val.index() != 0 )
-            return val;
+        while ( _text_sizes.size() > count )
+        {
+            _text_index.erase( _text_sizes.back().key );
+            _text_sizes.pop_back();
+        }
     }
 
-    return {};
-}
+public:
+    struct text_size
+    {
+        std::size_t key;
+        xui::font_id font;
+        float factor;
+        std::pmr::string text;
+        xui::size size;
+    };
 
-void xui::context::push_style_type( std::string_view name )
-{
-    _p->_types.push_back( { name.begin(), name.end(), _p->_res } );
-}
+    std::size_t _text_hits = 0;
+    std::size_t _text_misses = 0;
+    std::size_t _text_capacity = 4096;
+    std::pmr::list<text_size> _text_sizes;
+    std::pmr::unordered_map<std::size_t, std::pmr::list<text_size>::iterator> _text_index;
 
-void xui::context::pop_style_type()
-{
-    _p->_types.pop_back();
-}
+public:
+    std::pmr::deque<layout_state> _layouts;
+    std::pmr::unordered_map<std::size_t, layout_cache> _layout_caches;
 
-std::string_view xui::context::current_style_type() const
-{
-    return _p->_types.back().type;
-}
+public:
+    struct itemview_state
+    {
+        bool used = false;
+        double offset = 0;
+        float offset_x = 0;
+        xui::control_id selected;
+    };
+    struct itemview
+    {
+        xui::control_id id;
+        itemview_state * state = nullptr;
+        xui::listview_model * list = nullptr;
+        xui::treeview_model * tree = nullptr;
+        xui::rect rect;
+        float uniform = 0;
+        float indent = 0;
+        int row = 0;
+        int end = 0;
+        bool pushed = false;
+        bool clipped = false;
+        xui::alignment_flag align = xui::alignment_flag::ALIGN_CENTER;
+        std::array<xui::border, 4> borders;
+        std::array<xui::filled, 4> filleds;
+        std::array<xui::color, 4> colors;
+        xui::border arrow_border;
+        xui::filled arrow_filled;
+        int first = 0;
+        int fetched = 0;
+        xui::item_model::item_batch * batch = nullptr;
+
+        // only lists with variable rows leave uniform at 0
+        double offset( int row ) const
+        {
+            return uniform > 0 ? row * (double)uniform : list->row_offset( row );
+        }
+        int row_at( double offset, int count ) const
+        {
+            return uniform > 0 ? std::min( int( offset / uniform ), count - 1 ) : list->row_at( offset );
+        }
+    };
 
-void xui::context::push_style_element( std::string_view name )
-{
-    _p->_types.back().elements.push_back( { name.begin(), name.end() } );
-}
+    std::pmr::deque<itemview> _itemviews;
+    std::pmr::unordered_map<std::size_t, itemview_state> _itemview_states;
 
-void xui::context::pop_style_element()
-{
-    _p->_types.back().elements.pop_back();
-}
+public:
+    struct tableview
+    {
+        xui::control_id id;
+        itemview_state * state = nullptr;
+        xui::tableview_model * model = nullptr;
+        xui::rect rect;
+        xui::rect body;
+        float item_h = 0;
+        float header_h = 0;
+        float header_w = 0;
+        float frozen_w = 0;
+        int row = 0;
+        int row_end = 0;
+        int cell = 0;
+        bool pushed = false;
+        std::array<std::uint32_t, 2> clips = {};
+        xui::item_model::item_batch * batch = nullptr;
+        std::vector<int> cols;
+        std::vector<float> lefts;
+        xui::alignment_flag align = xui::alignment_flag::ALIGN_CENTER;
+        std::array<xui::border, 4> borders;
+        std::array<xui::filled, 4> filleds;
+        std::array<xui::color, 4> colors;
+
+        // cell rect before clipping, frozen columns ignore the horizontal scroll
+        xui::rect cell_rect( int view_row, int col, float factor ) const
+        {
+            float x = col < model->frozen_cols() ? rect.x + header_w + lefts[col] : body.x + lefts[col] - ( lefts[model->frozen_cols()] + state->offset_x * factor );
+            float y = body.y + float( ( view_row * (double)item_h - state->offset * factor ) );
+            return { x, y, lefts[col + 1] - lefts[col], item_h };
+        }
+    };
 
-std::string_view xui::context::current_style_element() const
-{
-    return _p->_types.back().elements.back();
-}
+    std::pmr::deque<tableview> _tableviews;
 
-void xui::context::push_style_status( xui::event_status status )
-{
-    _p->_types.back().status.push_back( status );
-}
+public:
+    // batches are reused across frames, nested popups each take the next one
+    xui::item_model::item_batch & fetch_rows( xui::item_model * model, xui::control_id parent, int first, int count, std::span<const int> roles )
+    {
+        if ( _batch_depth == _batches.size() )
+            _batches.emplace_back();
 
-void xui::context::pop_style_status()
-{
-    _p->_types.back().status.pop_back();
-}
+        auto & batch = _batches[_batch_depth++];
+        model->fetch_rows( parent, first, count, roles, batch );
+        return batch;
+    }
+    xui::item_model::item_batch & fetch_items( xui::item_model * model, std::span<const xui::control_id> ids, std::span<const int> roles )
+    {
+        if ( _batch_depth == _batches.size() )
+            _batches.emplace_back();
 
-xui::event_status xui::context::current_style_status() const
-{
-    return _p->_types.back().status.back();
-}
+        auto & batch = _batches[_batch_depth++];
+        model->fetch_items( ids, roles, batch );
+        return batch;
+    }
+    // cells row-major in the order tableview_item visits them, fetched again when a header click sorts
+    void fetch_cells( tableview & view )
+    {
+        static constexpr int roles[] = { xui::tableview_model::NAME };
 
-void xui::context::push_disable( bool val )
-{
-    _p->_disables.push_back( val );
-}
-
-void xui::context::pop_disable()
-{
-    _p->_disables.pop_back();
-}
-
-bool xui::context::current_disable() const
-{
-    if ( _p->_disables.empty() )
-        return false;
+        std::pmr::vector<xui::control_id> ids( &_frame->arena );
+        ids.reserve( ( view.row_end - view.row ) * view.cols.size() );
+        for ( int i = view.row; i < view.row_end; i++ )
+        {
+            auto row = view.model->source_row( i );
+            for ( auto col : view.cols )
+                ids.push_back( view.model->index( row, col, {} ) );
+        }
 
-    return _p->_disables.back();
-}
+        if ( view.batch == nullptr )
+            view.batch = &fetch_items( view.model, ids, roles );
+        else
+            view.model->fetch_items( ids, roles, *view.batch );
+    }
 
-void xui::context::push_zlevel( size_t val )
-{
-    _p->_zlevels.push_back( val );
-}
+    std::size_t _batch_depth = 0;
+    std::pmr::deque<xui::item_model::item_batch> _batches;
 
-void xui::context::pop_zlevel()
-{
-    _p->_zlevels.pop_back();
-}
+public:
+    struct menu_geometry
+    {
+        bool used = false;
+        bool valid = false;
+        const xui::item_model * model = nullptr;
+        xui::control_id parent;
+        xui::font_id font = {};
+        float factor = 0;
+        std::uint64_t revision = 0;
+        int count = 0;
+        float width = 0;
+    };
 
-size_t xui::context::current_zlevel() const
-{
-    if ( _p->_zlevels.empty() )
-        return 0;
+    // popup size of one menu level, stale once the model revision, font or scale moves on
+    menu_geometry & find_menu_geometry( const xui::item_model * model, xui::control_id parent, xui::font_id font )
+    {
+        auto & geo = _menu_geometries[hash_value( model, hash_value( parent, hash_value( font, hash_value( _factor, 0 ) ) ) )];
+        if ( geo.model != model || geo.parent != parent || geo.font != font || geo.factor != _factor || geo.revision != model->revision() )
+            geo = { false, false, model, parent, font, _factor, model->revision() };
 
-    return _p->_zlevels.back();
-}
+        use( geo.used );
+        return geo;
+    }
 
-void xui::context::push_viewport( const xui::rect & rect )
-{
-    _p->_viewports.push_back( rect );
-}
+    std::pmr::unordered_map<std::size_t, menu_geometry> _menu_geometries;
 
-void xui::context::pop_viewport()
-{
-    _p->_viewports.pop_back();
-}
+public:
+    struct paint_state
+    {
+        bool live = false;
+        std::size_t hash = 0;
+        std::size_t age = 0;
+    };
 
-xui::rect xui::context::current_viewport() const
-{
-    if ( _p->_viewports.empty() )
+    xui::paint_id stroke_paint( const xui::border & border )
     {
-        return {};
-    }
+        auto hash = hash_value( border, xui::hash( "stroke" ) );
 
-    return _p->_viewports.back();
-}
+        auto it = _paint_index.find( hash );
+        if ( it == _paint_index.end() )
+        {
+            auto id = alloc_paint( hash );
 
-void xui::context::push_font_id( xui::font_id font )
-{
-    _p->_fonts.push_back( font );
-}
+            _strokes[id] = border;
+            if ( _impl != nullptr )
+                _impl->create_paint( id, border );
 
-void xui::context::pop_font_id()
-{
-    _p->_fonts.pop_back();
-}
+            it = _paint_index.insert( { hash, id } ).first;
+        }
 
-xui::font_id xui::context::current_font_id() const
-{
-    if ( _p->_fonts.empty() )
-    {
-        return xui::invalid_font_id;
+        _paint_states[it->second].age = 0;
+        return it->second;
     }
+    xui::paint_id fill_paint( const xui::filled & filled )
+    {
+        auto hash = hash_value( filled, xui::hash( "filled" ) );
 
-    return _p->_fonts.back();
-}
+        auto it = _paint_index.find( hash );
+        if ( it == _paint_index.end() )
+        {
+            auto id = alloc_paint( hash );
 
-void xui::context::push_window_id( xui::window_id id )
-{
-    _p->_windows.push_back( id );
-}
+            _fills[id] = filled;
+            if ( _impl != nullptr )
+                _impl->create_paint( id, filled );
 
-void xui::context::pop_window_id()
-{
-    return _p->_windows.pop_back();
-}
+            it = _paint_index.insert( { hash, id } ).first;
+        }
 
-xui::window_id xui::context::current_window_id() const
-{
-    if ( _p->_windows.empty() )
-    {
-        return xui::invalid_window_id;
+        _paint_states[it->second].age = 0;
+        return it->second;
     }
+    xui::paint_id alloc_paint( std::size_t hash )
+    {
+        xui::paint_id id = 0;
 
-    return _p->_windows.back();
-}
+        if ( !_free_paints.empty() )
+        {
+            id = _free_paints.back();
+            _free_paints.pop_back();
+        }
+        else
+        {
+            id = static_cast<xui::paint_id>( _paint_states.size() );
+            _strokes.emplace_back();
+            _fills.emplace_back();
+            _paint_states.emplace_back();
+        }
 
-void xui::context::push_texture_id( xui::texture_id id )
-{
-    _p->_textures.push_back( id );
-}
+        _paint_states[id] = { true, hash, 0 };
+        return id;
+    }
+    // paints unused for max_paint_age frames go back to the free list, the backend drops its native objects
+    void evict_paints()
+    {
+        for ( xui::paint_id id = 1; id < _paint_states.size(); id++ )
+        {
+            auto & state = _paint_states[id];
+            if ( !state.live || ++state.age <= max_paint_age )
+                continue;
+
+            if ( _impl != nullptr )
+                _impl->remove_paint( id );
+
+            _paint_index.erase( state.hash );
+            _strokes[id] = {};
+            _fills[id] = {};
+            state = {};
+            _free_paints.push_back( id );
+        }
+    }
 
-void xui::context::pop_texture_id()
-{
-    _p->_textures.pop_back();
-}
+    std::pmr::vector<xui::border> _strokes;
+    std::pmr::vector<xui::filled> _fills;
+    std::pmr::vector<paint_state> _paint_states;
+    std::pmr::vector<xui::paint_id> _free_paints;
+    std::pmr::unordered_map<std::size_t, xui::paint_id> _paint_index;
 
-xui::texture_id xui::context::current_texture_id() const
-{
-    if ( _p->_textures.empty() )
+public:
+    // the part of a command that is certainly painted with opaque pixels, empty when it has none
+    xui::rect opaque_rect( const xui::drawlist & list, const xui::drawcmd & cmd ) const
     {
-        return xui::invalid_texture_id;
-    }
+        if ( cmd.kind != xui::drawcmd::RECT || cmd.clip != 0 )
+            return {};
 
-    return _p->_textures.back();
-}
+        const auto & fill = list.fill( cmd );
+        auto color = std::get_if<xui::color>( &fill.colors );
+        if ( fill.style != xui::filled::SOLID || color == nullptr || color->a != 255 )
+            return {};
 
-void xui::context::push_control_id( xui::control_id id )
-{
-    _p->_ctl_ids.push_back( { id.begin(), id.end() } );
-}
+        // rounded corners and the stroke edge are left out, the fill is solid inside them
+        const auto & border = list.stroke( cmd );
+        const auto & rect = list.rects[cmd.index].rect;
+        float inset = std::max( { border.radius.x, border.radius.y, border.radius.z, border.radius.w } ) + border.width;
 
-void xui::context::pop_control_id()
-{
-    _p->_ctl_ids.pop_back();
-}
+        float x1 = std::ceil( rect.x + inset ), y1 = std::ceil( rect.y + inset );
+        float x2 = std::floor( rect.x + rect.w - inset ), y2 = std::floor( rect.y + rect.h - inset );
+        if ( x2 <= x1 || y2 <= y1 )
+            return {};
 
-xui::control_id xui::context::current_control_id() const
-{
-    if ( _p->_ctl_ids.empty() )
-    {
-        return {};
+        return { x1, y1, x2 - x1, y2 - y1 };
     }
+    // walks every window from its topmost command down and drops the commands a later opaque rect hides completely
+    void cull_occluded( xui::drawlist & list )
+    {
+        auto end = list.commands.size();
+        while ( end > 0 )
+        {
+            auto id = list.commands[end - 1].id;
+            auto beg = end;
 
-    return _p->_ctl_ids.back();
-}
+            _occluders.clear();
+            for ( ; beg > 0 && list.commands[beg - 1].id == id; beg-- )
+            {
+                auto & cmd = list.commands[beg - 1];
 
-xui::control_id xui::context::get_act_control_id() const
-{
-    return _p->_act_ctl_id[current_window_id()];
-}
+                // bounds are truncated to whole pixels, one more pixel covers the antialiased edge
+                xui::rect bounds = { float( cmd.left ), float( cmd.top ), float( cmd.right - cmd.left + 1 ), float( cmd.bottom - cmd.top + 1 ) };
+                auto covered = std::find_if( _occluders.begin(), _occluders.end(), [&]( const auto & it )
+                {
+                    return bounds.x >= it.x && bounds.y >= it.y && bounds.x + bounds.w <= it.x + it.w && bounds.y + bounds.h <= it.y + it.h;
+                } );
+                if ( covered != _occluders.end() )
+                {
+                    _occluded_commands++;
+                    _occluded_pixels += std::size_t( bounds.w * bounds.h );
+                    cmd.kind = xui::drawcmd::NONE;
+                    continue;
+                }
 
-xui::control_id xui::context::get_hot_control_id() const
-{
-    return _p->_hot_ctl_id[current_window_id()];
-}
+                auto rect = opaque_rect( list, cmd );
+                if ( rect.w <= 0 || rect.h <= 0 )
+                    continue;
 
-void xui::context::set_act_control_id( xui::control_id id )
-{
-    _p->_act_ctl_id[current_window_id()] = id;
-}
+                // only the largest occluders are kept so the test stays linear in the command count
+                if ( _occluders.size() < max_occluders )
+                {
+                    _occluders.push_back( rect );
+                }
+                else
+                {
+                    auto smallest = std::min_element( _occluders.begin(), _occluders.end(), []( const auto & left, const auto & right )
+                    {
+                        return left.w * left.h < right.w * right.h;
+                    } );
+                    if ( smallest->w * smallest->h < rect.w * rect.h )
+                        *smallest = rect;
+                }
+            }
 
-void xui::context::set_hot_control_id( xui::control_id id )
-{
-    _p->_hot_ctl_id[current_window_id()] = id;
-}
+            end = beg;
+        }
 
-xui::event_status xui::context::current_event_status( bool hot, xui::event event )
-{
-    auto wid = current_window_id();
-    auto cid = current_control_id();
-    auto aid = get_act_control_id();
-    auto hid = get_hot_control_id();
+        std::erase_if( list.commands, []( const auto & it )
+        {
+            return it.kind == xui::drawcmd::NONE;
+        } );
+    }
 
-    auto rect = current_viewport();
-    auto pos = _p->_impl->get_cursor_pos( wid );
+    bool _occlusion = false;
+    std::size_t _drawn_pixels = 0;
+    std::size_t _occluded_pixels = 0;
+    std::size_t _occluded_commands = 0;
+    std::pmr::vector<xui::rect> _occluders;
 
-    if ( current_disable() )
+public:
+    struct cached_region
     {
-        return xui::event_status::DISABLED;
-    }
-    else if ( !aid.empty() )
+        cached_region( std::pmr::memory_resource * res )
+            : states( res )
+        {
+        }
+
+        bool used = false;
+        bool valid = false;
+        std::size_t version = 0;
+        xui::window_id window = xui::invalid_window_id;
+        std::size_t zlevel = 0;
+        float factor = 0;
+        xui::rect rect;
+        xui::rect clip;
+        xui::control_id act;
+        std::size_t first = 0;
+        std::size_t count = 0;
+        // used flags of the layout, menu and itemview states the region's widgets keep across frames
+        std::pmr::vector<bool *> states;
+    };
+    struct region_scope
     {
-        if ( cid == aid )
-            return xui::event_status::ACTIVE;
-        else
-            return xui::event_status::NORMAL;
-    }
-    else if ( hot && cid == hid )
+        cached_region * region = nullptr;
+        bool recording = false;
+        std::size_t ctl_id_idx = 0;
+        std::size_t first = 0;
+        xui::control_id act;
+        bool stale = false;
+    };
+
+    // states reached while a region records are kept alive by its replays, a replay never runs the widgets that mark them
+    void use( bool & used )
     {
-        return xui::event_status::ACTIVE;
+        used = true;
+
+        if ( !_region_scopes.empty() )
+            _region_scopes.back().region->states.push_back( &used );
     }
-    else if ( _p->_impl->get_event( wid, xui::event::WINDOW_ACTIVE ) )
+    // pointer input over the region or a control of it still holding the focus makes its last commands stale
+    bool touched( const cached_region & region )
     {
-        if ( _p->_impl->get_event( wid, event ) && rect.contains( pos ) )
+        const auto & input = this->input( region.window );
+
+        auto act = _act_ctl_id.find( region.window );
+        if ( !region.act.empty() && act != _act_ctl_id.end() && act->second == region.act )
+            return true;
+
+        xui::vec2 last_pos = { input.cursor_pos.x - input.cursor_dt.x, input.cursor_pos.y - input.cursor_dt.y };
+        bool over = region.rect.contains( input.cursor_pos ) || region.rect.contains( last_pos );
+
+        bool mouse = false;
+        for ( int i = xui::event::MOUSE_EVENT_BEG; i <= xui::event::MOUSE_EVENT_END; i++ )
+            mouse = mouse || input.test( xui::event( i ) );
+
+        auto last = _last_frame->inputs.find( region.window );
+        if ( last != _last_frame->inputs.end() )
         {
-            set_act_control_id( cid );
+            if ( last->second.test( xui::event::WINDOW_ACTIVE ) != input.test( xui::event::WINDOW_ACTIVE ) )
+                return true;
 
-            if ( hot ) set_hot_control_id( cid );
+            for ( int i = xui::event::MOUSE_EVENT_BEG; i <= xui::event::MOUSE_EVENT_END; i++ )
+                mouse = mouse || last->second.test( xui::event( i ) );
+        }
 
-            return xui::event_status::ACTIVE;
+        if ( over && ( mouse || input.cursor_dt != xui::vec2() || input.wheel != xui::vec2() ) )
+            return true;
+
+        return std::any_of( input.touchs.begin(), input.touchs.end(), [&]( const auto & it )
+        {
+            return region.rect.contains( it );
+        } );
+    }
+    // copies one command and its payload into a list built in this frame, moving the geometry by -origin
+    void append( const xui::drawlist & from, xui::drawlist & list, xui::drawcmd cmd, std::pmr::unordered_map<std::uint32_t, std::uint32_t> & clips, const xui::vec2 & origin = {} )
+    {
+        auto move = [&]( auto & value )
+        {
+            if constexpr ( std::is_same_v<std::decay_t<decltype( value )>, xui::rect> )
+                value = { value.x - origin.x, value.y - origin.y, value.w, value.h };
+            else
+                value = { value.x - origin.x, value.y - origin.y };
+        };
+        auto push = [&]( auto & payloads, auto && element )
+        {
+            cmd.index = static_cast<std::uint32_t>( payloads.size() );
+            payloads.push_back( std::move( element ) );
+        };
+
+        switch ( cmd.kind )
+        {
+        case xui::drawcmd::TEXT:
+        {
+            auto element = from.texts[cmd.index];
+            element.text = { copy<char>( element.text ), element.text.size() };
+            move( element.rect );
+            push( list.texts, std::move( element ) );
+            break;
         }
-        else if ( rect.contains( pos ) )
+        case xui::drawcmd::LINE:
         {
-            return xui::event_status::HOVER;
+            auto element = from.lines[cmd.index];
+            move( element.p1 );
+            move( element.p2 );
+            push( list.lines, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::RECT:
+        {
+            auto element = from.rects[cmd.index];
+            move( element.rect );
+            push( list.rects, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::PATH:
+        {
+            const auto & path = from.paths[cmd.index];
+            xui::drawcmd::path_element element{ { path.commands.begin(), path.commands.end(), &_frame->arena }, { path.points.begin(), path.points.end(), &_frame->arena } };
+            for ( auto & it : element.points )
+                move( it );
+            push( list.paths, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::IMAGE:
+        {
+            auto element = from.images[cmd.index];
+            move( element.rect );
+            push( list.images, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::CIRCLE:
+        {
+            auto element = from.circles[cmd.index];
+            move( element.center );
+            push( list.circles, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::ELLIPSE:
+        {
+            auto element = from.ellipses[cmd.index];
+            move( element.center );
+            push( list.ellipses, std::move( element ) );
+            break;
+        }
+        case xui::drawcmd::POLYGON:
+        {
+            auto points = from.polygons[cmd.index].points;
+            auto copied = copy<xui::vec2>( points );
+            for ( std::size_t i = 0; i < points.size(); i++ )
+                move( copied[i] );
+            push( list.polygons, xui::drawcmd::polygon_element{ { copied, points.size() } } );
+            break;
+        }
+        default:
+            return;
         }
-    }
 
-    return xui::event_status::NORMAL;
-}
+        if ( cmd.clip != 0 )
+        {
+            auto it = clips.find( cmd.clip );
+            if ( it == clips.end() )
+            {
+                it = clips.insert( { cmd.clip, static_cast<std::uint32_t>( list.clips.size() ) } ).first;
+                list.clips.push_back( from.clips[cmd.clip] );
+                move( list.clips.back() );
+            }
+            cmd.clip = it->second;
+        }
 
-void xui::context::begin()
-{
-    _p->_commands.clear();
-}
+        _paint_states[cmd.stroke].age = 0;
+        _paint_states[cmd.fill].age = 0;
 
-std::span<xui::drawcmd> xui::context::end()
-{
-    _p->_zvalue = 0;
-    _p->_ctl_id_idx = 0;
+        list.commands.push_back( cmd );
+    }
+    void replay( cached_region & region )
+    {
+        std::pmr::unordered_map<std::uint32_t, std::uint32_t> clips( &_frame->arena );
 
-    _p->_types.clear();
-    _p->_fonts.clear();
-    _p->_styles.clear();
-    _p->_ctl_ids.clear();
-    _p->_windows.clear();
-    _p->_zlevels.clear();
-    _p->_textures.clear();
-    _p->_disables.clear();
-    _p->_viewports.clear();
+        for ( std::size_t i = region.first; i < region.first + region.count; i++ )
+            append( _last_frame->list, _frame->list, _last_frame->recorded[i], clips );
+
+        for ( auto used : region.states )
+            *used = true;
+    }
+
+    std::pmr::unordered_map<std::size_t, cached_region> _regions;
+    std::pmr::deque<region_scope> _region_scopes;
 
-    std::sort( _p->_commands.begin(), _p->_commands.end(), []( const auto & left, const auto & right )
+public:
+    // concatenates a finished list per window and z, in submission order inside each bucket
+    void concat_buckets( xui::drawlist & list )
     {
-        if ( left.id <= right.id )
-            return ( left.z < right.z );
+        struct bucket
+        {
+            xui::window_id id;
+            std::uint32_t z;
+            std::size_t offset;
+        };
 
-        return false;
-    } );
+        std::pmr::vector<bucket> buckets( &_frame->arena );
+        std::pmr::vector<std::uint32_t> slots( &_frame->arena );
+        slots.reserve( list.commands.size() );
 
-    return _p->_commands;
+        std::size_t last = 0;
+        for ( const auto & it : list.commands )
+        {
+            if ( buckets.empty() || buckets[last].id != it.id || buckets[last].z != it.z )
+            {
+                last = std::find_if( buckets.begin(), buckets.end(), [&]( const auto & val ) { return val.id == it.id && val.z == it.z; } ) - buckets.begin();
+                if ( last == buckets.size() )
+                    buckets.push_back( { it.id, it.z, 0 } );
+            }
+            buckets[last].offset++;
+            slots.push_back( static_cast<std::uint32_t>( last ) );
+        }
+
+        if ( buckets.size() < 2 )
+            return;
+
+        std::pmr::vector<std::uint32_t> order( buckets.size(), &_frame->arena );
+        std::iota( order.begin(), order.end(), 0 );
+        std::sort( order.begin(), order.end(), [&]( auto left, auto right )
+        {
+            return buckets[left].id != buckets[right].id ? buckets[left].id < buckets[right].id : buckets[left].z < buckets[right].z;
+        } );
+
+        std::size_t offset = 0;
+        for ( auto i : order )
+        {
+            auto count = buckets[i].offset;
+            buckets[i].offset = offset;
+            offset += count;
+        }
+
+        std::pmr::vector<xui::drawcmd> commands( list.commands.size(), list.commands.get_allocator() );
+        for ( std::size_t i = 0; i < list.commands.size(); i++ )
+            commands[buckets[slots[i]].offset++] = list.commands[i];
+        list.commands.swap( commands );
+    }
+    // orders a finished list and gives every command its clipped pixel bounds
+    void finish( xui::drawlist & list )
+    {
+        concat_buckets( list );
+
+        list.strokes = _strokes;
+        list.fills = _fills;
+
+        auto clamp = []( float val )
+        {
+            return static_cast<std::int16_t>( std::clamp( val, float( std::numeric_limits<std::int16_t>::min() ), float( std::numeric_limits<std::int16_t>::max() ) ) );
+        };
+
+        // commands that their clip hides completely never reach the backend
+        std::erase_if( list.commands, [&]( auto & it )
+        {
+            auto rect = list.measure( it );
+            if ( it.clip != 0 )
+            {
+                rect = intersect( rect, list.clip( it ) );
+                if ( rect.w <= 0 || rect.h <= 0 )
+                    return true;
+            }
+
+            it.left = clamp( rect.x );
+            it.top = clamp( rect.y );
+            it.right = clamp( rect.x + rect.w );
+            it.bottom = clamp( rect.y + rect.h );
+
+            return false;
+        } );
+    }
+
+public:
+    struct layer
+    {
+        bool used = false;
+        bool valid = false;
+        float factor = 0;
+        int width = 0;
+        int height = 0;
+        xui::vec2 fraction;
+        xui::texture_id texture = xui::invalid_texture_id;
+    };
+    struct layer_scope
+    {
+        layer * target = nullptr;
+        bool recording = false;
+        std::size_t first = 0;
+        xui::rect rect;
+        bool stale = false;
+    };
+
+    // moves the commands recorded since first into their own list and has the backend draw it into the layer texture
+    void render_layer( layer & target, std::size_t first, const xui::rect & rect )
+    {
+        const auto & list = _frame->list;
+        xui::drawlist layer_list( &_frame->arena );
+        std::pmr::unordered_map<std::uint32_t, std::uint32_t> clips( &_frame->arena );
+
+        layer_list.clips.push_back( unbounded_clip );
+        for ( std::size_t i = first; i < list.commands.size(); i++ )
+            append( list, layer_list, list.commands[i], clips, { rect.x, rect.y } );
+
+        // a render target is a single surface, the window the commands were drawn in does not matter
+        for ( auto & it : layer_list.commands )
+            it.id = 0;
+
+        finish( layer_list );
+        _impl->update_render_target( target.texture, layer_list );
+
+        target.valid = true;
+        target.factor = _factor;
+    }
+
+    std::pmr::unordered_map<std::size_t, layer> _layers;
+    std::pmr::deque<layer_scope> _layer_scopes;
+    std::pmr::vector<std::pair<xui::window_id, xui::rect>> _layer_damages;
+};
+
+xui::context::context( std::pmr::memory_resource * res )
+    : _p( new ( res->allocate( sizeof( private_p ) ) ) private_p( res ) )
+{
+}
+
+xui::context::~context()
+{
+    auto res = _p->_res;
+
+    _p->~private_p();
+
+    res->deallocate( _p, sizeof( private_p ) );
+}
+
+std::string_view xui::context::dark_style()
+{
+    return
+        R"(
+    *{
+        font-color: white;
+        text-align: center;
+
+        margin: vec4( 0, 0, 0, 0 );
+        padding: vec4( 0, 0, 0, 0 );
+
+        filled: filled( solid, black );
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+    },
+    window{
+        border: border( solid, 1, transparent, vec4( 10, 10, 10, 10 ) );
+        filled: filled( solid, black );
+    },
+    window-resize{
+        stroke: stroke( solid, 1, white );
+        filled: filled( dense2, hatch( white, transparent ) );
+    },
+    window-titlebar{
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+        border: border( solid, 1, transparent, vec4( 10, 10, 0, 0 ) );
+    },
+    window-titlebar-title{
+        font-color: white;
+        text-align: left vcenter;
+    },
+    window-titlebar-closebox{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    window-titlebar-closebox:hover{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
+        filled: filled( solid, red );
+    },
+    window-titlebar-closebox:disable{
+        stroke: stroke( solid, 1, darkgray );
+        border: border( solid, 1, transparent, vec4( 0, 10, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    window-titlebar-minimizebox{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    window-titlebar-minimizebox:hover{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 94, 92, 91 ) );
+    },
+    window-titlebar-minimizebox:disable{
+        stroke: stroke( solid, 1, darkgray );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    window-titlebar-maximizebox{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    window-titlebar-maximizebox:hover{
+        stroke: stroke( solid, 1, white );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 94, 92, 91 ) );
+    },
+    window-titlebar-maximizebox:disable{
+        stroke: stroke( solid, 1, darkgray );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    menubar{
+        font-color: white;
+        text-align: center;
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+    },
+    menubar:hover{
+        filled: filled( solid, green );
+    },
+    menubar:active{
+        filled: filled( solid, darkgray );
+    },
+    menubar-menu{
+        filled: filled( solid, rgb( 76, 74, 72 ) );
+    },
+    menubar-menu-item{
+    },
+    menubar-menu-item:hover{
+        filled: filled( solid, green );
+    },
+    menubar-menu-item:active{
+        filled: filled( solid, darkgray );
+    },
+    label{
+        font-color: green;
+    },
+    image{
+    },
+    slider{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, white );
+        direction: bottom to top;
+    },
+    slider:hover{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, green );
+    },
+    slider:active{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, yellow );
+    },
+    slider-cursor{
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, red );
+    },
+    process{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 94, 92, 91 ) );
+    },
+    process-text{
+        font-color: white;
+    },
+    process-cursor{
+        border-color: transparent;
+        filled: filled( solid, red );
+        direction: left to right;
+    },
+    button{
+        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
+        filled: filled( solid, white );
+    },
+    button:hover{
+        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
+        filled: filled( solid, red );
+    },
+    button:active{
+        border: border( solid, 1, black, vec4( 10, 0, 10, 0 ) );
+        filled: filled( solid, green );
+    },
+    button-text{
+        font-color: black;
+        text-align: right top;
+    },
+    button-text:hover{
+        font-color: white;
+    },
+    button-text:active{
+        font-color: red;
+    },
+    radio{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, blue );
+    },
+    radio:hover{
+        filled: filled( solid, light( blue ) );
+    },
+    radio:active{
+        filled: filled( solid, green );
+    },
+    radio-indicator{
+        filled: filled( solid, white );
+    },
+    check{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, blue );
+    },
+    check:hover{
+        filled: filled( solid, light( blue ) );
+    },
+    check:active{
+        filled: filled( solid, green );
+    },
+    check-indicator{
+        stroke: stroke( solid, 3, white );
+    },
+    scrollbar{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, green );
+    },
+    scrollbar-cursor{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, red );
+    },
+    scrollbar-arrow{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, blue );
+        stroke: stroke( solid, 3, white );
+    },
+    combobox{
+    },
+    combobox-list{
+    },
+    tabview{
+    },
+    tabview-tab{
+    },
+    listview{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 45, 45, 48 ) );
+        item-height: 24;
+    },
+    listview-item{
+        text-align: left vcenter;
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, transparent );
+    },
+    listview-item:hover{
+        filled: filled( solid, rgb( 62, 62, 64 ) );
+    },
+    listview-item:active{
+        filled: filled( solid, darkgray );
+    },
+    treeview{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 45, 45, 48 ) );
+        item-height: 24;
+        indent: 16;
+    },
+    treeview-item{
+        text-align: left vcenter;
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, transparent );
+    },
+    treeview-item:hover{
+        filled: filled( solid, rgb( 62, 62, 64 ) );
+    },
+    treeview-item:active{
+        filled: filled( solid, darkgray );
+    },
+    treeview-item-arrow{
+        border: border( solid, 1, transparent, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, white );
+    },
+    tableview{
+        border: border( solid, 1, white, vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 45, 45, 48 ) );
+        item-height: 24;
+        header-height: 24;
+    },
+    tableview-header{
+        text-align: center;
+        border: border( solid, 1, rgb( 63, 63, 70 ), vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, rgb( 37, 37, 38 ) );
+    },
+    tableview-header:hover{
+        filled: filled( solid, rgb( 62, 62, 64 ) );
+    },
+    tableview-item{
+        text-align: left vcenter;
+        border: border( solid, 1, rgb( 63, 63, 70 ), vec4( 0, 0, 0, 0 ) );
+        filled: filled( solid, transparent );
+    },
+    tableview-item:hover{
+        filled: filled( solid, rgb( 62, 62, 64 ) );
+    },
+    tableview-item:active{
+        filled: filled( solid, darkgray );
+    }
+)";
+}
+
+std::string_view xui::context::light_style()
+{
+    return "";
+}
+
+void xui::context::init( xui::implement * impl )
+{
+    _p->_impl = impl;
+
+    for ( xui::paint_id id = 0; id < _p->_paint_states.size(); id++ )
+    {
+        if ( _p->_paint_states[id].live )
+        {
+            impl->create_paint( id, _p->_strokes[id] );
+            impl->create_paint( id, _p->_fills[id] );
+        }
+    }
+}
+
+void xui::context::release()
+{
+    _p->trim_text_sizes( 0 );
+
+    if ( _p->_impl != nullptr )
+    {
+        for ( const auto & it : _p->_layers )
+        {
+            if ( it.second.texture != xui::invalid_texture_id )
+                _p->_impl->remove_render_target( it.second.texture );
+        }
+        _p->_layers.clear();
+
+        for ( xui::paint_id id = 0; id < _p->_paint_states.size(); id++ )
+        {
+            if ( _p->_paint_states[id].live )
+                _p->_impl->remove_paint( id );
+        }
+    }
+
+    _p->_impl = nullptr;
+}
+
+void xui::context::set_scale( float factor )
+{
+    _p->_factor = factor;
+}
+
+void xui::context::reserve_frame_memory( std::size_t size )
+{
+    // both arenas may still hold live frames, each one takes the size when begin() clears it
+    _p->_frames[0].pending_reserve = size;
+    _p->_frames[1].pending_reserve = size;
+}
+
+std::size_t xui::context::frame_memory_used() const
+{
+    return _p->_frame->arena.used();
+}
+
+std::size_t xui::context::frame_memory_capacity() const
+{
+    return _p->_frame->arena.capacity();
+}
+
+std::size_t xui::context::frame_memory_high_water() const
+{
+    return std::max( _p->_frames[0].arena.high_water(), _p->_frames[1].arena.high_water() );
+}
+
+xui::size xui::context::font_size( xui::font_id id, std::string_view text )
+{
+    return _p->font_size( id, text );
+}
+
+void xui::context::remove_font( xui::font_id id )
+{
+    for ( auto it = _p->_text_sizes.begin(); it != _p->_text_sizes.end(); )
+    {
+        if ( it->font == id )
+        {
+            _p->_text_index.erase( it->key );
+            it = _p->_text_sizes.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    _p->_impl->remove_font( id );
+}
+
+void xui::context::set_font_cache_capacity( std::size_t count )
+{
+    _p->_text_capacity = count;
+    _p->trim_text_sizes( count );
+}
+
+std::size_t xui::context::font_cache_hits() const
+{
+    return _p->_text_hits;
+}
+
+std::size_t xui::context::font_cache_misses() const
+{
+    return _p->_text_misses;
+}
+
+bool xui::context::changed() const
+{
+    return !_p->_frame->damages.empty();
+}
+
+std::span<const xui::rect> xui::context::damaged_rects( xui::window_id id ) const
+{
+    for ( const auto & it : _p->_frame->damages )
+    {
+        if ( it.id == id )
+            return it.rects;
+    }
+
+    return {};
+}
+
+void xui::context::set_occlusion_culling( bool enable )
+{
+    _p->_occlusion = enable;
+}
+
+std::size_t xui::context::drawn_pixels() const
+{
+    return _p->_drawn_pixels;
+}
+
+std::size_t xui::context::occluded_pixels() const
+{
+    return _p->_occluded_pixels;
+}
+
+std::size_t xui::context::occluded_commands() const
+{
+    return _p->_occluded_commands;
+}
+
+void xui::context::push_style( xui::style * style )
+{
+    _p->_styles.emplace_back( style );
+}
+
+void xui::context::pop_style()
+{
+    _p->_styles.pop_back();
+}
+
+std::string xui::context::current_style_name() const
+{
+    std::string result;
+
+    if ( auto name = !_p->_ctl_ids.empty() ? _p->_ctl_ids.back().name() : std::string(); !name.empty() )
+    {
+        result.append( name );
+        result.append( "#" );
+    }
+
+    result.append( _p->_types.back().type.begin(), _p->_types.back().type.end() );
+
+    for ( const auto & it : _p->_types.back().elements )
+    {
+        result.append( "-" );
+        result.append( it );
+    }
+
+    if ( !_p->_types.back().status.empty() )
+    {
+        if ( _p->_types.back().status.back() != xui::event_status::NORMAL )
+        {
+            result.append( ":" );
+            result.append( status_name( _p->_types.back().status.back() ) );
+        }
+    }
+
+    return result;
+}
+
+std::size_t xui::context::current_style_hash( std::string_view attr ) const
+{
+    // same byte sequence as current_style_name() + "@" + attr, hashed piece by piece; a named
+    // control id hashes to the same value as its name, so it can seed the chain directly
+    std::size_t result = xui::hash( "" );
+
+    if ( !_p->_ctl_ids.empty() && !_p->_ctl_ids.back().empty() )
+    {
+        result = xui::hash( "#", 1, _p->_ctl_ids.back().hash() );
+    }
+
+    result = xui::hash( _p->_types.back().type.data(), _p->_types.back().type.size(), result );
+
+    for ( const auto & it : _p->_types.back().elements )
+    {
+        result = xui::hash( "-", 1, result );
+        result = xui::hash( it.data(), it.size(), result );
+    }
+
+    if ( !_p->_types.back().status.empty() && _p->_types.back().status.back() != xui::event_status::NORMAL )
+    {
+        auto status = status_name( _p->_types.back().status.back() );
+
+        result = xui::hash( ":", 1, result );
+        result = xui::hash( status.data(), status.size(), result );
+    }
+
+    result = xui::hash( "@", 1, result );
+    result = xui::hash( attr.data(), attr.size(), result );
+
+    return result;
+}
+
+xui::style::variant xui::context::current_style( std::string_view attr ) const
+{
+    const auto & type = _p->_types.back();
+    auto key = current_style_hash( attr );
+    auto id = _p->_ctl_ids.empty() ? 0 : _p->_ctl_ids.back().hash();
+    auto status = type.status.empty() ? std::string_view{} : status_name( type.status.back() );
+
+    for ( auto it = _p->_styles.rbegin(); it != _p->_styles.rend(); ++it )
+    {
+        auto val = ( *it )->find( key, [&]()
+        {
+            std::array<std::byte, 256> buffer;
+            std::pmr::monotonic_buffer_resource res( buffer.data(), buffer.size() );
+            std::pmr::vector<std::string_view> elements( type.elements.begin(), type.elements.end(), &res );
+
+            return ( *it )->find( id, type.type, elements, status, attr );
+        } );
+        if ( val.index() != 0 )
+            return val;
+    }
+
+    return {};
+}
+
+void xui::context::push_style_type( std::string_view name )
+{
+    _p->_types.push_back( { name.begin(), name.end(), _p->_res } );
+}
+
+void xui::context::pop_style_type()
+{
+    _p->_types.pop_back();
+}
+
+std::string_view xui::context::current_style_type() const
+{
+    return _p->_types.back().type;
+}
+
+void xui::context::push_style_element( std::string_view name )
+{
+    _p->_types.back().elements.push_back( { name.begin(), name.end() } );
+}
+
+void xui::context::pop_style_element()
+{
+    _p->_types.back().elements.pop_back();
+}
+
+std::string_view xui::context::current_style_element() const
+{
+    return _p->_types.back().elements.back();
+}
+
+void xui::context::push_style_status( xui::event_status status )
+{
+    _p->_types.back().status.push_back( status );
+}
+
+void xui::context::pop_style_status()
+{
+    _p->_types.back().status.pop_back();
+}
+
+xui::event_status xui::context::current_style_status() const
+{
+    return _p->_types.back().status.back();
+}
+
+void xui::context::push_disable( bool val )
+{
+    _p->_disables.push_back( val );
+}
+
+void xui::context::pop_disable()
+{
+    _p->_disables.pop_back();
+}
+
+bool xui::context::current_disable() const
+{
+    if ( _p->_disables.empty() )
+        return false;
+
+    return _p->_disables.back();
+}
+
+void xui::context::push_zlevel( size_t val )
+{
+    _p->_zlevels.push_back( val );
+}
+
+void xui::context::pop_zlevel()
+{
+    _p->_zlevels.pop_back();
+}
+
+size_t xui::context::current_zlevel() const
+{
+    if ( _p->_zlevels.empty() )
+        return 0;
+
+    return _p->_zlevels.back();
+}
+
+void xui::context::push_viewport( const xui::rect & rect )
+{
+    _p->_viewports.push_back( rect );
+}
+
+void xui::context::pop_viewport()
+{
+    _p->_viewports.pop_back();
+}
+
+xui::rect xui::context::current_viewport() const
+{
+    if ( _p->_viewports.empty() )
+    {
+        return {};
+    }
+
+    return _p->_viewports.back();
+}
+
+void xui::context::push_clip( const xui::rect & rect )
+{
+    auto & clips = _p->_frame->list.clips;
+    auto clip = intersect( current_clip(), rect );
+
+    _p->_clips.push_back( static_cast<std::uint32_t>( clips.size() ) );
+    clips.push_back( clip );
+}
+
+void xui::context::pop_clip()
+{
+    _p->_clips.pop_back();
+}
+
+xui::rect xui::context::current_clip() const
+{
+    if ( !_p->_clips.empty() )
+    {
+        return _p->_frame->list.clips[_p->_clips.back()];
+    }
+
+    auto id = current_window_id();
+    if ( _p->_impl == nullptr || id == xui::invalid_window_id )
+    {
+        return unbounded_clip;
+    }
+
+    const auto & input = _p->input( id );
+    return { 0, 0, input.rect.w, input.rect.h };
+}
+
+bool xui::context::begin_cached_region( xui::control_id id, std::size_t version )
+{
+    auto it = _p->_regions.find( id.hash() );
+    if ( it == _p->_regions.end() )
+        it = _p->_regions.emplace( id.hash(), private_p::cached_region( _p->_res ) ).first;
+
+    auto & region = it->second;
+    auto window = current_window_id();
+    auto rect = current_viewport();
+    auto clip = current_clip();
+
+    bool replay = region.valid && !region.used && region.version == version && region.window == window && region.zlevel == current_zlevel()
+        && region.factor == _p->_factor && region.rect == rect && region.clip == clip && !_p->touched( region );
+
+    region.used = true;
+    push_control_id( id );
+    _p->_region_scopes.push_back( { &region, !replay, _p->_ctl_id_idx, _p->_frame->list.commands.size(), get_act_control_id() } );
+    _p->_ctl_id_idx = 0;
+
+    if ( replay )
+    {
+        _p->replay( region );
+        return false;
+    }
+
+    region.valid = false;
+    region.version = version;
+    region.window = window;
+    region.zlevel = current_zlevel();
+    region.factor = _p->_factor;
+    region.rect = rect;
+    region.clip = clip;
+    region.states.clear();
+
+    return true;
+}
+
+void xui::context::end_cached_region()
+{
+    auto scope = _p->_region_scopes.back();
+    auto & region = *scope.region;
+    auto & frame = *_p->_frame;
+
+    _p->_region_scopes.pop_back();
+    _p->_ctl_id_idx = scope.ctl_id_idx;
+    pop_control_id();
+
+    // the region owns the focus it took while recording and records again until it lets go
+    if ( scope.recording )
+    {
+        auto act = get_act_control_id();
+        region.act = !act.empty() && ( act != scope.act || act == region.act ) ? act : xui::control_id();
+    }
+
+    region.first = frame.recorded.size();
+    region.count = frame.list.commands.size() - scope.first;
+    region.valid = !scope.stale;
+    frame.recorded.insert( frame.recorded.end(), frame.list.commands.begin() + scope.first, frame.list.commands.end() );
+
+    if ( !_p->_region_scopes.empty() )
+    {
+        auto & parent = _p->_region_scopes.back().region->states;
+        parent.insert( parent.end(), region.states.begin(), region.states.end() );
+    }
+}
+
+bool xui::context::push_layer( xui::control_id id, const xui::rect & rect )
+{
+    auto & layer = _p->_layers[id.hash()];
+
+    // the texture sits on whole pixels so it is blitted 1:1 instead of resampled
+    xui::rect snapped = { std::floor( rect.x ), std::floor( rect.y ), 0, 0 };
+    int width = (int)( std::ceil( rect.x + rect.w ) - snapped.x ), height = (int)( std::ceil( rect.y + rect.h ) - snapped.y );
+    xui::vec2 fraction = { rect.x - snapped.x, rect.y - snapped.y };
+    snapped.w = (float)width;
+    snapped.h = (float)height;
+
+    _p->use( layer.used );
+
+    if ( _p->_impl == nullptr || rect.w <= 0 || rect.h <= 0 )
+    {
+        _p->_layer_scopes.push_back( { nullptr, true, 0, rect } );
+        return true;
+    }
+
+    if ( layer.texture == xui::invalid_texture_id || layer.width != width || layer.height != height )
+    {
+        if ( layer.texture != xui::invalid_texture_id )
+            _p->_impl->remove_render_target( layer.texture );
+
+        layer.texture = _p->_impl->create_render_target( width, height );
+        layer.width = width;
+        layer.height = height;
+        layer.valid = false;
+    }
+
+    // content rendered at one sub-pixel offset is stale at another
+    if ( layer.fraction.x != fraction.x || layer.fraction.y != fraction.y )
+    {
+        layer.fraction = fraction;
+        layer.valid = false;
+    }
+
+    bool recording = !layer.valid || layer.factor != _p->_factor;
+    _p->_layer_scopes.push_back( { &layer, recording, _p->_frame->list.commands.size(), snapped } );
+
+    // the content is clipped to the layer only, the texture must not depend on where the parents cut it
+    if ( recording )
+    {
+        auto & clips = _p->_frame->list.clips;
+
+        _p->_clips.push_back( static_cast<std::uint32_t>( clips.size() ) );
+        clips.push_back( snapped );
+    }
+
+    return recording;
+}
+
+void xui::context::pop_layer()
+{
+    auto scope = _p->_layer_scopes.back();
+
+    _p->_layer_scopes.pop_back();
+    if ( scope.target == nullptr )
+        return;
+
+    auto & layer = *scope.target;
+    xui::rect rect = { scope.rect.x, scope.rect.y, (float)layer.width, (float)layer.height };
+
+    if ( scope.recording )
+    {
+        _p->_clips.pop_back();
+        _p->render_layer( layer, scope.first, rect );
+        _p->_layer_damages.push_back( { current_window_id(), rect } );
+        if ( scope.stale )
+            layer.valid = false;
+    }
+
+    _p->_frame->list.commands.resize( scope.first );
+    draw_image( layer.texture, rect );
+}
+
+void xui::context::invalidate_layer( xui::control_id id )
+{
+    auto it = _p->_layers.find( id.hash() );
+    if ( it != _p->_layers.end() )
+        it->second.valid = false;
+}
+
+bool xui::context::is_visible( const xui::rect & rect ) const
+{
+    auto clip = current_clip();
+
+    return rect.w > 0 && rect.h > 0 && rect.x < clip.x + clip.w && clip.x < rect.x + rect.w && rect.y < clip.y + clip.h && clip.y < rect.y + rect.h;
+}
+
+void xui::context::push_font_id( xui::font_id font )
+{
+    _p->_fonts.push_back( font );
+}
+
+void xui::context::pop_font_id()
+{
+    _p->_fonts.pop_back();
+}
+
+xui::font_id xui::context::current_font_id() const
+{
+    if ( _p->_fonts.empty() )
+    {
+        return xui::invalid_font_id;
+    }
+
+    return _p->_fonts.back();
+}
+
+void xui::context::push_window_id( xui::window_id id )
+{
+    _p->_windows.push_back( id );
+}
+
+void xui::context::pop_window_id()
+{
+    return _p->_windows.pop_back();
+}
+
+xui::window_id xui::context::current_window_id() const
+{
+    if ( _p->_windows.empty() )
+    {
+        return xui::invalid_window_id;
+    }
+
+    return _p->_windows.back();
+}
+
+void xui::context::push_texture_id( xui::texture_id id )
+{
+    _p->_textures.push_back( id );
+}
+
+void xui::context::pop_texture_id()
+{
+    _p->_textures.pop_back();
+}
+
+xui::texture_id xui::context::current_texture_id() const
+{
+    if ( _p->_textures.empty() )
+    {
+        return xui::invalid_texture_id;
+    }
+
+    return _p->_textures.back();
+}
+
+void xui::context::push_control_id( xui::control_id id )
+{
+    _p->_ctl_ids.push_back( id );
+}
+
+void xui::context::pop_control_id()
+{
+    _p->_ctl_ids.pop_back();
+}
+
+xui::control_id xui::context::current_control_id() const
+{
+    if ( _p->_ctl_ids.empty() )
+    {
+        return {};
+    }
+
+    return _p->_ctl_ids.back();
+}
+
+xui::control_id xui::context::get_act_control_id() const
+{
+    return _p->_act_ctl_id[current_window_id()];
+}
+
+xui::control_id xui::context::get_hot_control_id() const
+{
+    return _p->_hot_ctl_id[current_window_id()];
+}
+
+void xui::context::set_act_control_id( xui::control_id id )
+{
+    _p->_act_ctl_id[current_window_id()] = id;
+}
+
+void xui::context::set_hot_control_id( xui::control_id id )
+{
+    _p->_hot_ctl_id[current_window_id()] = id;
+}
+
+xui::event_status xui::context::current_event_status( bool hot, xui::event event )
+{
+    auto wid = current_window_id();
+    auto cid = current_control_id();
+    auto aid = get_act_control_id();
+    auto hid = get_hot_control_id();
+
+    auto rect = intersect( current_viewport(), current_clip() );
+    const auto & input = _p->input( wid );
+    auto pos = input.cursor_pos;
+
+    if ( current_disable() )
+    {
+        return xui::event_status::DISABLED;
+    }
+    else if ( !aid.empty() )
+    {
+        if ( cid == aid )
+            return xui::event_status::ACTIVE;
+        else
+            return xui::event_status::NORMAL;
+    }
+    else if ( hot && cid == hid )
+    {
+        return xui::event_status::ACTIVE;
+    }
+    else if ( input.test( xui::event::WINDOW_ACTIVE ) )
+    {
+        if ( input.test( event ) && rect.contains( pos ) )
+        {
+            set_act_control_id( cid );
+
+            if ( hot ) set_hot_control_id( cid );
+
+            return xui::event_status::ACTIVE;
+        }
+        else if ( rect.contains( pos ) )
+        {
+            return xui::event_status::HOVER;
+        }
+    }
+
+    return xui::event_status::NORMAL;
+}
+
+const xui::input_state & xui::context::current_input()
+{
+    return _p->input( current_window_id() );
+}
+
+void xui::context::begin()
+{
+    std::swap( _p->_frame, _p->_last_frame );
+
+    _p->_frame->clear();
+    _p->_frame->reserve( *_p->_last_frame );
+    _p->_frame->list.clips.push_back( unbounded_clip );
+}
+
+const xui::drawlist & xui::context::end()
+{
+    _p->_ctl_id_idx = 0;
+
+    _p->_types.clear();
+    _p->_fonts.clear();
+    _p->_styles.clear();
+    _p->_ctl_ids.clear();
+    _p->_windows.clear();
+    _p->_zlevels.clear();
+    _p->_textures.clear();
+    _p->_disables.clear();
+    _p->_viewports.clear();
+    _p->_clips.clear();
+    _p->_layouts.clear();
+
+    for ( auto it = _p->_layout_caches.begin(); it != _p->_layout_caches.end(); )
+    {
+        if ( !it->second.used )
+        {
+            it = _p->_layout_caches.erase( it );
+        }
+        else
+        {
+            it->second.used = false;
+            ++it;
+        }
+    }
+
+    _p->_itemviews.clear();
+    _p->_tableviews.clear();
+    _p->_batch_depth = 0;
+    for ( auto it = _p->_menu_geometries.begin(); it != _p->_menu_geometries.end(); )
+    {
+        if ( !it->second.used )
+        {
+            it = _p->_menu_geometries.erase( it );
+        }
+        else
+        {
+            it->second.used = false;
+            ++it;
+        }
+    }
+    for ( auto it = _p->_itemview_states.begin(); it != _p->_itemview_states.end(); )
+    {
+        if ( !it->second.used )
+        {
+            it = _p->_itemview_states.erase( it );
+        }
+        else
+        {
+            it->second.used = false;
+            ++it;
+        }
+    }
+    _p->_region_scopes.clear();
+    for ( auto it = _p->_regions.begin(); it != _p->_regions.end(); )
+    {
+        if ( !it->second.used )
+        {
+            it = _p->_regions.erase( it );
+        }
+        else
+        {
+            it->second.used = false;
+            ++it;
+        }
+    }
+    _p->_layer_scopes.clear();
+    for ( auto it = _p->_layers.begin(); it != _p->_layers.end(); )
+    {
+        if ( !it->second.used )
+        {
+            if ( _p->_impl != nullptr && it->second.texture != xui::invalid_texture_id )
+                _p->_impl->remove_render_target( it->second.texture );
+
+            it = _p->_layers.erase( it );
+        }
+        else
+        {
+            it->second.used = false;
+            ++it;
+        }
+    }
+
+    auto & frame = *_p->_frame;
+    const auto & last = *_p->_last_frame;
+
+    auto & list = frame.list;
+    const auto & last_list = last.list;
+
+    _p->finish( list );
+
+    _p->_occluded_pixels = 0;
+    _p->_occluded_commands = 0;
+    if ( _p->_occlusion )
+        _p->cull_occluded( list );
+
+    _p->_drawn_pixels = 0;
+    frame.hashes.reserve( list.commands.size() );
+    for ( const auto & it : list.commands )
+    {
+        _p->_drawn_pixels += std::size_t( it.right - it.left ) * std::size_t( it.bottom - it.top );
+
+        // handles are recycled, so the diff hashes the paint content instead
+        auto seed = hash_value( list.clip( it ), hash_value( _p->_paint_states[it.fill].hash, _p->_paint_states[it.stroke].hash ) );
+        frame.hashes.push_back( hash_value( list, it, seed ) );
+    }
+
+    size_t i = 0, j = 0;
+    while ( i < list.commands.size() || j < last_list.commands.size() )
+    {
+        xui::window_id id;
+        if ( j == last_list.commands.size() )
+            id = list.commands[i].id;
+        else if ( i == list.commands.size() )
+            id = last_list.commands[j].id;
+        else
+            id = std::min( list.commands[i].id, last_list.commands[j].id );
+
+        size_t i_end = i, j_end = j;
+        while ( i_end < list.commands.size() && list.commands[i_end].id == id ) ++i_end;
+        while ( j_end < last_list.commands.size() && last_list.commands[j_end].id == id ) ++j_end;
+
+        size_t prefix = 0, suffix = 0;
+        while ( i + prefix < i_end && j + prefix < j_end && frame.hashes[i + prefix] == last.hashes[j + prefix] ) ++prefix;
+        while ( i_end - suffix > i + prefix && j_end - suffix > j + prefix && frame.hashes[i_end - suffix - 1] == last.hashes[j_end - suffix - 1] ) ++suffix;
+
+        if ( i + prefix != i_end || j + prefix != j_end )
+        {
+            xui::context::private_p::damage damage{ id, std::pmr::vector<xui::rect>( &frame.arena ) };
+
+            for ( size_t k = i + prefix; k < i_end - suffix; k++ )
+                add_damage( damage.rects, list.commands[k].bounds() );
+            for ( size_t k = j + prefix; k < j_end - suffix; k++ )
+                add_damage( damage.rects, last_list.commands[k].bounds() );
+
+            if ( !damage.rects.empty() )
+                frame.damages.push_back( std::move( damage ) );
+        }
+
+        i = i_end;
+        j = j_end;
+    }
+
+    // a redrawn layer keeps its texture id, so its image command hashes the same as before
+    for ( const auto & [id, rect] : _p->_layer_damages )
+    {
+        auto it = std::find_if( frame.damages.begin(), frame.damages.end(), [&]( const auto & val ) { return val.id == id; } );
+        if ( it == frame.damages.end() )
+            it = frame.damages.insert( frame.damages.end(), { id, std::pmr::vector<xui::rect>( &frame.arena ) } );
+
+        add_damage( it->rects, rect );
+    }
+    _p->_layer_damages.clear();
+
+    if ( _p->_impl != nullptr )
+    {
+        for ( const auto & it : frame.damages )
+            _p->_impl->damage_window( it.id, it.rects );
+    }
+
+    _p->evict_paints();
+
+    return list;
+}
+
+bool xui::context::begin_window( std::string_view title, xui::texture_id icon_id, int flags )
+{
+    return begin_window( current_control_id().child( _p->_ctl_id_idx++ ), title, icon_id, flags );
+}
+
+bool xui::context::begin_window( xui::control_id ctl_id, std::string_view title, xui::texture_id icon_id, int flags )
+{
+    auto wid = current_window_id();
+    auto wrect = current_viewport();
+    const auto & input = _p->input( wid );
+    auto window_status = input.status;
+
+    draw_control_id( ctl_id, [&]()
+    {
+        if ( ( window_status & xui::window_status::WINDOW_SHOW ) != 0 )
+        {
+            if ( ( flags & xui::window_flag::WINDOW_NO_BACKGROUND ) == 0 )
+            {
+                draw_style_type( "window", [&]()
+                {
+                    draw_rect( wrect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+                } );
+            }
+
+            draw_zlevel( window_z_level, [&]()
+            {
+                draw_style_type( "window", [&]()
+                {
+                    xui::rect title_rect = { 0, 0, wrect.w, XUI_SCALE( 30 ) };
+                    xui::rect move_rect = { 0, 0, wrect.w - XUI_SCALE( 150 ), XUI_SCALE( 30 ) };
+                    xui::rect resize_rect = { wrect.x + ( wrect.w - XUI_SCALE( 15 ) ), wrect.y + ( wrect.h - XUI_SCALE( 15 ) ), XUI_SCALE( 15 ), XUI_SCALE( 15 ) };
+
+                    auto dt = input.cursor_dt;
+                    auto wr = input.rect;
+
+                    if ( ( flags & xui::window_flag::WINDOW_NO_MOVE ) == 0 )
+                    {
+                        draw_control_id( current_control_id().child( "move" ), [&]()
+                        {
+                            draw_viewport( move_rect, [&]()
+                            {
+                                if ( current_event_status() == xui::event_status::ACTIVE )
+                                {
+                                    _p->_impl->set_window_rect( wid, { wr.x + dt.x, wr.y + dt.y, wr.w, wr.h } );
+                                }
+                            } );
+                        } );
+                    }
+                    if ( ( flags & xui::window_flag::WINDOW_NO_RESIZE ) == 0 )
+                    {
+                        draw_style_element( "resize", [&]()
+                        {
+                            draw_control_id( current_control_id().child( "resize" ), [&]()
+                            {
+                                draw_viewport( resize_rect, [&]()
+                                {
+                                    if ( current_event_status() == xui::event_status::ACTIVE )
+                                    {
+                                        _p->_impl->set_window_rect( wid, { wr.x, wr.y, std::max( wr.w + dt.x, XUI_SCALE( 150 ) ), std::max( wr.h + dt.y, title_rect.h + resize_rect.h ) } );
+                                    }
+                                } );
+                            } );
+
+                            draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                .moveto( { resize_rect.x, resize_rect.y + resize_rect.h } )
+                                .lineto( { resize_rect.x + resize_rect.w, resize_rect.y + resize_rect.h } )
+                                .lineto( { resize_rect.x + resize_rect.w, resize_rect.y } )
+                                .lineto( { resize_rect.x, resize_rect.y + resize_rect.h } )
+                                .closepath();
+                        } );
+                    }
+                    if ( ( flags & xui::window_flag::WINDOW_NO_TITLEBAR ) == 0 )
+                    {
+                        draw_style_element( "titlebar", [&]()
+                        {
+                            wrect.y += XUI_SCALE( 30 );
+                            wrect.h -= XUI_SCALE( 30 );
+
+                            draw_rect( title_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                            draw_image( icon_id, { XUI_SCALE( 8 ), XUI_SCALE( 5 ), XUI_SCALE( 20 ), XUI_SCALE( 20 ) } );
+
+                            draw_style_element( "title", [&]()
+                            {
+                                draw_text( title, current_font_id(), { XUI_SCALE( 30 ), XUI_SCALE( 5 ), wrect.w - XUI_SCALE( 150 ), XUI_SCALE( 20 ) }, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                            } );
+
+                            xui::rect box_rect = { title_rect.w, title_rect.y, XUI_SCALE( 50 ), title_rect.h };
+
+                            draw_control_id( current_control_id().child( "closebox" ), [&]()
+                            {
+                                draw_style_element( "closebox", [&]()
+                                {
+                                    box_rect.x -= XUI_SCALE( 50 );
+
+                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_CLOSEBOX ) != 0, [&]()
+                                    {
+                                        draw_viewport( box_rect, [&]()
+                                        {
+                                            xui::event_status status = current_event_status();
+                                            draw_style_status( status, [&]()
+                                            {
+                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                                    .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                    .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                    .closepath()
+                                                    .moveto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                    .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                    .closepath();
+                                            } );
+
+                                            if ( status == xui::event_status::ACTIVE ) _p->_impl->remove_window( wid );
+                                        } );
+                                    } );
+                                } );
+                            } );
+
+                            draw_control_id( current_control_id().child( "maximizebox" ), [&]()
+                            {
+                                draw_style_element( "maximizebox", [&]()
+                                {
+                                    box_rect.x -= XUI_SCALE( 50 );
+
+                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_MAXIMIZEBOX ) != 0, [&]()
+                                    {
+                                        draw_viewport( box_rect, [&]()
+                                        {
+                                            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+                                            draw_style_status( status, [&]()
+                                            {
+                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                                                if ( ( window_status & xui::window_status::WINDOW_MAXIMIZE ) != 0 )
+                                                {
+                                                    draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                                        .moveto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y + XUI_SCALE( 3 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 3 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .closepath()
+                                                        .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 3 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 3 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 3 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 3 ) } )
+                                                        .closepath();
+                                                }
+                                                else
+                                                {
+                                                    draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                                        .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
+                                                        .closepath();
+                                                }
+                                            } );
+
+                                            if ( status == xui::event_status::ACTIVE )
+                                            {
+                                                _p->_impl->set_window_status( wid, ( ( window_status & xui::window_status::WINDOW_MAXIMIZE ) != 0 ) ? xui::window_status::WINDOW_RESTORE : xui::window_status::WINDOW_MAXIMIZE );
+                                            }
+                                        } );
+                                    } );
+                                } );
+                            } );
+
+                            draw_control_id( current_control_id().child( "minimizebox" ), [&]()
+                            {
+                                draw_style_element( "minimizebox", [&]()
+                                {
+                                    box_rect.x -= XUI_SCALE( 50 );
+
+                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_MINIMIZEBOX ) != 0, [&]()
+                                    {
+                                        draw_viewport( box_rect, [&]()
+                                        {
+                                            xui::event_status status = current_event_status();
+                                            draw_style_status( status, [&]()
+                                            {
+                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                                    .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y } )
+                                                    .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y } )
+                                                    .closepath();
+                                            } );
+
+                                            if ( status == xui::event_status::ACTIVE ) _p->_impl->set_window_status( wid, xui::window_status::WINDOW_MINIMIZE );
+                                        } );
+                                    } );
+                                } );
+                            } );
+                        } );
+                    }
+                } );
+            } );
+
+            push_viewport( wrect );
+        }
+    } );
+
+    return ( ( window_status & xui::window_status::WINDOW_SHOW ) != 0 );
+}
+
+void xui::context::end_window()
+{
+    pop_viewport();
+
+    auto id = current_window_id();
+    auto wrect = current_viewport();
+
+    const auto & input = _p->input( id );
+
+    if ( !get_act_control_id().empty() && !input.test( xui::event::KEY_MOUSE_LEFT ) )
+    {
+        set_act_control_id( {} );
+    }
+    if ( get_act_control_id().empty() && wrect.contains( input.cursor_pos ) && input.test( xui::event::WINDOW_ACTIVE ) && input.test( xui::event::KEY_MOUSE_LEFT ) )
+    {
+        set_hot_control_id( {} );
+    }
+}
+
+bool xui::context::image( xui::texture_id id )
+{
+    return image( current_control_id().child( _p->_ctl_id_idx++ ), id );
+}
+
+bool xui::context::image( xui::control_id ctl_id, xui::texture_id id )
+{
+    if ( !is_visible( current_viewport() ) )
+        return true;
+
+    draw_style_type( "image", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            draw_image( id, current_viewport() );
+        } );
+    } );
+
+    return true;
+}
+
+bool xui::context::label( std::string_view text )
+{
+    return label( current_control_id().child( _p->_ctl_id_idx++ ), text );
+}
+
+bool xui::context::label( xui::control_id ctl_id, std::string_view text )
+{
+    if ( !is_visible( current_viewport() ) )
+        return true;
+
+    draw_style_type( "label", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            draw_text( text, current_font_id(), current_viewport(), current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+        } );
+    } );
+
+    return true;
+}
+
+bool xui::context::radio( bool & checked )
+{
+    return radio( current_control_id().child( _p->_ctl_id_idx++ ), checked );
+}
+
+bool xui::context::radio( xui::control_id ctl_id, bool & checked )
+{
+    if ( !is_visible( current_viewport() ) )
+        return checked;
+
+    draw_style_type( "radio", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto id = current_window_id();
+            auto rect = current_viewport();
+            float raduis = std::min( rect.w, rect.h ) / 2;
+
+            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+            if ( status == xui::event_status::ACTIVE )
+                checked = !checked;
+
+            draw_style_status( status, [&]()
+            {
+                draw_circle( { rect.x + raduis, rect.y + raduis }, raduis, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            } );
+
+            if ( checked )
+            {
+                draw_style_element( "indicator", [&]()
+                {
+                    draw_style_status( status, [&]()
+                    {
+                        draw_circle( { rect.x + raduis, rect.y + raduis }, ( raduis * 0.7f ), current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+                    } );
+                } );
+            }
+        } );
+    } );
+
+    return checked;
+}
+
+bool xui::context::check( bool & checked )
+{
+    return check( current_control_id().child( _p->_ctl_id_idx++ ), checked );
+}
+
+bool xui::context::check( xui::control_id ctl_id, bool & checked )
+{
+    if ( !is_visible( current_viewport() ) )
+        return checked;
+
+    draw_style_type( "check", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto id = current_window_id();
+            auto rect = current_viewport();
+            rect.w = std::min( rect.w, rect.h );
+            rect.h = rect.w;
+
+            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+            if ( status == xui::event_status::ACTIVE ) checked = !checked;
+
+            draw_style_status( status, [&]()
+            {
+                draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            } );
+
+            if ( checked )
+            {
+                draw_style_element( "indicator", [&]()
+                {
+                    draw_style_status( status, [&]()
+                    {
+                        draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                            .moveto( { rect.x + ( rect.w * 0.2f ), rect.y + ( rect.h * 0.5f ) } )
+                            .lineto( { rect.x + ( rect.w * 0.4f ), rect.y + ( rect.h * 0.7f ) } )
+                            .lineto( { rect.x + ( rect.w * 0.8f ), rect.y + ( rect.h * 0.2f ) } );
+                    } );
+                } );
+            }
+        } );
+    } );
+
+    return checked;
+}
+
+bool xui::context::button( std::string_view text )
+{
+    return button( current_control_id().child( _p->_ctl_id_idx++ ), text );
+}
+
+bool xui::context::button( xui::control_id ctl_id, std::string_view text )
+{
+    if ( !is_visible( current_viewport() ) )
+        return false;
+
+    xui::event_status status;
+
+    draw_style_type( "button", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto id = current_window_id();
+            auto rect = current_viewport();
+
+            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+
+            draw_style_status( status, [&]()
+            {
+                draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            } );
+
+            if ( !text.empty() )
+            {
+                draw_style_element( "text", [&]()
+                {
+                    draw_style_status( status, [&]()
+                    {
+                        draw_text( text, current_font_id(), rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                    } );
+                } );
+            }
+        } );
+    } );
+
+    return status == xui::event_status::ACTIVE;
+}
+
+float xui::context::slider( float & value, float min, float max )
+{
+    return slider( current_control_id().child( _p->_ctl_id_idx++ ), value, min, max );
+}
+
+float xui::context::slider( xui::control_id ctl_id, float & value, float min, float max )
+{
+    if ( !is_visible( current_viewport() ) )
+        return value;
+
+    draw_style_type( "slider", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto id = current_window_id();
+            auto back_rect = current_viewport();
+            xui::vec2 pos = _p->input( id ).cursor_pos;
+            xui::event_status status = current_event_status();
+
+            draw_style_status( status, [&]()
+            {
+                draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            } );
+
+            draw_style_element( "cursor", [&]()
+            {
+                float cursor_w = 0;
+                float cursor_h = 0;
+                float cursor_step = 0;
+                xui::rect cursor_rect = {};
+                float backleft = back_rect.x;
+                float backright = back_rect.x + back_rect.w;
+                float backtop = back_rect.y;
+                float backbottom = back_rect.y + back_rect.h;
+
+                switch ( current_style( "direction" ).value<xui::direction>( xui::direction::LEFT_RIGHT ) )
+                {
+                case xui::direction::LEFT_RIGHT:
+                {
+                    backleft += XUI_SCALE( 5 );
+                    backright -= XUI_SCALE( 5 );
+                    cursor_w = XUI_SCALE( 10.0f );
+                    cursor_h = backbottom - backtop;
+                    cursor_step = ( backright - backleft ) / ( max - min );
+                    if ( status == xui::event_status::ACTIVE )
+                        value = std::clamp( ( ( pos.x - backleft ) / ( backright - backleft ) ) * ( max - min ), min, max );
+
+                    cursor_rect = {
+                        back_rect.x + ( cursor_step * value ),
+                        back_rect.y,
+                        cursor_w,
+                        cursor_h
+                    };
+                    break;
+                }
+                case xui::direction::RIGHT_LEFT:
+                {
+                    backleft += XUI_SCALE( 5 );
+                    backright -= XUI_SCALE( 5 );
+                    cursor_w = XUI_SCALE( 10.0f );
+                    cursor_h = backbottom - backtop;
+                    cursor_step = ( backright - backleft ) / ( max - min );
+                    if ( status == xui::event_status::ACTIVE )
+                        value = std::clamp( ( ( backright - pos.x ) / ( backright - backleft ) ) * ( max - min ), min, max );
+
+                    cursor_rect = {
+                        ( back_rect.x + back_rect.w - cursor_w ) - ( cursor_step * value ),
+                        back_rect.y,
+                        cursor_w,
+                        cursor_h
+                    };
+                    break;
+                }
+                case xui::direction::TOP_BOTTOM:
+                {
+                    backtop += XUI_SCALE( 5 );
+                    backbottom -= XUI_SCALE( 5 );
+                    cursor_w = backright - backleft;
+                    cursor_h = XUI_SCALE( 10.0f );
+                    cursor_step = ( backbottom - backtop ) / ( max - min );
+                    if ( status == xui::event_status::ACTIVE )
+                        value = std::clamp( ( ( pos.y - backtop ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+
+                    cursor_rect = {
+                        back_rect.x,
+                        back_rect.y + ( cursor_step * value ),
+                        cursor_w,
+                        cursor_h
+                    };
+                    break;
+                }
+                case xui::direction::BOTTOM_TOP:
+                {
+                    backtop += XUI_SCALE( 5 );
+                    backbottom -= XUI_SCALE( 5 );
+                    cursor_w = backright - backleft;
+                    cursor_h = XUI_SCALE( 10.0f );
+                    cursor_step = ( backbottom - backtop ) / ( max - min );
+                    if ( status == xui::event_status::ACTIVE )
+                        value = std::clamp( ( ( backbottom - pos.y ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+
+                    cursor_rect = {
+                        back_rect.x,
+                        ( back_rect.y + back_rect.h - cursor_h ) - ( cursor_step * value ),
+                        cursor_w,
+                        cursor_h
+                    };
+                    break;
+                }
+                }
+
+                draw_style_status( status, [&]()
+                {
+                    draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+                } );
+            } );
+        } );
+    } );
+
+    return value;
 }
 
-bool xui::context::begin_window( std::string_view title, xui::texture_id icon_id, int flags )
+bool xui::context::process( float value, float min, float max, std::string_view text )
+{
+    return process( current_control_id().child( _p->_ctl_id_idx++ ), value, min, max, text );
+}
+
+bool xui::context::process( xui::control_id ctl_id, float value, float min, float max, std::string_view text )
+{
+    if ( !is_visible( current_viewport() ) )
+        return true;
+
+    draw_style_type( "process", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto back_rect = current_viewport();
+
+            draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+            draw_style_element( "cursor", [&]()
+            {
+                xui::rect cursor_rect;
+                value = ( value - min ) / ( max - min );
+
+                switch ( current_style( "direction" ).value<xui::direction>( xui::direction::LEFT_RIGHT ) )
+                {
+                case xui::direction::LEFT_RIGHT:
+                    cursor_rect = { back_rect.x, back_rect.y, back_rect.w * value, back_rect.h };
+                    break;
+                case xui::direction::RIGHT_LEFT:
+                    cursor_rect = { back_rect.x + ( back_rect.w - ( back_rect.w * value ) ), back_rect.y, back_rect.w * value, back_rect.h };
+                    break;
+                case xui::direction::TOP_BOTTOM:
+                    cursor_rect = { back_rect.x, back_rect.y, back_rect.w, back_rect.h * value };
+                    break;
+                case xui::direction::BOTTOM_TOP:
+                    cursor_rect = { back_rect.x, back_rect.y + ( back_rect.h - ( back_rect.h * value ) ), back_rect.w, back_rect.h * value };
+                    break;
+                default:
+                    break;
+                }
+
+                draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            } );
+
+            if ( !text.empty() )
+            {
+                draw_style_element( "text", [&]()
+                {
+                    draw_text( text, current_font_id(), back_rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                } );
+            }
+        } );
+    } );
+
+    return true;
+}
+
+float xui::context::scrollbar( float & value, float step, float min, float max, xui::direction dir )
 {
-    return begin_window( std::format( "_window_{}", _p->_ctl_id_idx++ ), title, icon_id, flags );
+    return scrollbar( current_control_id().child( _p->_ctl_id_idx++ ), value, step, min, max, dir );
 }
 
-bool xui::context::begin_window( xui::control_id ctl_id, std::string_view title, xui::texture_id icon_id, int flags )
-{
-    auto wid = current_window_id();
-    auto wrect = current_viewport();
-    auto cursorpos = _p->_impl->get_cursor_pos( wid );
-    auto window_status = _p->_impl->get_window_status( wid );
+float xui::context::scrollbar( xui::control_id ctl_id, float & value, float step, float min, float max, xui::direction dir )
+{
+    if ( !is_visible( current_viewport() ) )
+        return value;
+
+    draw_style_type( "scrollbar", [&]()
+    {
+        draw_control_id( ctl_id, [&]()
+        {
+            auto id = current_window_id();
+            auto back_rect = current_viewport();
+            xui::vec2 pos = _p->input( id ).cursor_pos;
+            float arrow_radius = std::min( back_rect.w, back_rect.h );
+            xui::event_status status;
+
+            draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+            draw_style_element( "cursor", [&]()
+            {
+                draw_control_id( ctl_id.child( "cursor" ), [&]()
+                {
+                    std::string_view element;
+
+                    float cursor_w = 0;
+                    float cursor_h = 0;
+                    float cursor_step = 0;
+                    xui::rect cursor_rect = {};
+                    xui::rect detect_rect = {};
+
+                    switch ( dir )
+                    {
+                    case xui::direction::LEFT_RIGHT:
+                    case xui::direction::RIGHT_LEFT:
+                        detect_rect = { back_rect.x + arrow_radius,  back_rect.y, back_rect.w - arrow_radius * 2, back_rect.h };
+                        break;
+                    case xui::direction::TOP_BOTTOM:
+                    case xui::direction::BOTTOM_TOP:
+                        detect_rect = { back_rect.x,  back_rect.y + arrow_radius, back_rect.w, back_rect.h - arrow_radius * 2 };
+                        break;
+                    default:
+                        break;
+                    }
+
+                    draw_viewport( detect_rect, [&]()
+                    {
+                        status = current_event_status();
+
+                        float backleft = detect_rect.x;
+                        float backright = detect_rect.x + detect_rect.w;
+                        float backtop = detect_rect.y;
+                        float backbottom = detect_rect.y + detect_rect.h;
+
+                        switch ( dir )
+                        {
+                        case xui::direction::LEFT_RIGHT:
+                        {
+                            backleft += arrow_radius;
+                            backright -= arrow_radius;
+                            cursor_w = arrow_radius * 2;
+                            cursor_h = backbottom - backtop;
+                            cursor_step = ( backright - backleft ) / ( max - min );
+
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( ( ( pos.x - backleft ) / ( backright - backleft ) ) * ( max - min ), min, max );
+
+                            cursor_rect = {
+                                backleft + ( cursor_step * value ) - ( cursor_w * 0.5f ),
+                                backtop,
+                                cursor_w,
+                                cursor_h
+                            };
+                            element = "horizontal";
+                            break;
+                        }
+                        case xui::direction::RIGHT_LEFT:
+                        {
+                            backleft += arrow_radius;
+                            backright -= arrow_radius;
+                            cursor_w = arrow_radius * 2;
+                            cursor_h = backbottom - backtop;
+                            cursor_step = ( backright - backleft ) / ( max - min );
+
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( ( ( backright - pos.x ) / ( backright - backleft ) ) * ( max - min ), min, max );
+
+                            cursor_rect = {
+                                ( backleft + ( backright - backleft ) ) - ( cursor_step * value ) - ( cursor_w * 0.5f ),
+                                backtop,
+                                cursor_w,
+                                cursor_h
+                            };
+
+                            element = "horizontal";
+                            break;
+                        }
+                        case xui::direction::TOP_BOTTOM:
+                        {
+                            backtop += arrow_radius;
+                            backbottom -= arrow_radius;
+                            cursor_w = backright - backleft;
+                            cursor_h = arrow_radius * 2;
+                            cursor_step = ( backbottom - backtop ) / ( max - min );
+
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( ( ( pos.y - backtop ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+
+                            cursor_rect = {
+                                backleft,
+                                backtop + ( cursor_step * value ) - ( cursor_h * 0.5f ),
+                                cursor_w,
+                                cursor_h
+                            };
 
-    draw_control_id( ctl_id, [&]()
-    {
-        if ( ( window_status & xui::window_status::WINDOW_SHOW ) != 0 )
-        {
-            if ( ( flags & xui::window_flag::WINDOW_NO_BACKGROUND ) == 0 )
-            {
-                draw_style_type( "window", [&]()
-                {
-                    draw_rect( wrect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-                } );
-            }
+                            element = "vertical";
+                            break;
+                        }
+                        case xui::direction::BOTTOM_TOP:
+                        {
+                            backtop += arrow_radius;
+                            backbottom -= arrow_radius;
+                            cursor_w = backright - backleft;
+                            cursor_h = arrow_radius * 2;
+                            cursor_step = ( backbottom - backtop ) / ( max - min );
 
-            draw_zlevel( window_z_level, [&]()
-            {
-                draw_style_type( "window", [&]()
-                {
-                    xui::rect title_rect = { 0, 0, wrect.w, XUI_SCALE( 30 ) };
-                    xui::rect move_rect = { 0, 0, wrect.w - XUI_SCALE( 150 ), XUI_SCALE( 30 ) };
-                    xui::rect resize_rect = { wrect.x + ( wrect.w - XUI_SCALE( 15 ) ), wrect.y + ( wrect.h - XUI_SCALE( 15 ) ), XUI_SCALE( 15 ), XUI_SCALE( 15 ) };
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( ( ( backbottom - pos.y ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
 
-                    auto dt = _p->_impl->get_cursor_dt( wid );
-                    auto wr = _p->_impl->get_window_rect( wid );
+                            cursor_rect = {
+                                backleft,
+                                ( backtop + ( backbottom - backtop ) ) - ( cursor_step * value ) - ( cursor_h * 0.5f ),
+                                cursor_w,
+                                cursor_h
+                            };
 
-                    if ( ( flags & xui::window_flag::WINDOW_NO_MOVE ) == 0 )
-                    {
-                        draw_control_id( std::format( "{}_{}", current_control_id(), "move" ), [&]()
+                            element = "vertical";
+                            break;
+                        }
+                        }
+
+                        draw_style_element( element, [&]()
                         {
-                            draw_viewport( move_rect, [&]()
+                            draw_style_status( status, [&]()
                             {
-                                if ( current_event_status() == xui::event_status::ACTIVE )
-                                {
-                                    _p->_impl->set_window_rect( wid, { wr.x + dt.x, wr.y + dt.y, wr.w, wr.h } );
-                                }
+                                draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
                             } );
                         } );
-                    }
-                    if ( ( flags & xui::window_flag::WINDOW_NO_RESIZE ) == 0 )
-                    {
-                        draw_style_element( "resize", [&]()
-                        {
-                            draw_control_id( std::format( "{}_{}", current_control_id(), "resize" ), [&]()
-                            {
-                                draw_viewport( resize_rect, [&]()
-                                {
-                                    if ( current_event_status() == xui::event_status::ACTIVE )
-                                    {
-                                        _p->_impl->set_window_rect( wid, { wr.x, wr.y, std::max( wr.w + dt.x, XUI_SCALE( 150 ) ), std::max( wr.h + dt.y, title_rect.h + resize_rect.h ) } );
-                                    }
-                                } );
-                            } );
+                    } );
+                } );
+            } );
 
-                            draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                .moveto( { resize_rect.x, resize_rect.y + resize_rect.h } )
-                                .lineto( { resize_rect.x + resize_rect.w, resize_rect.y + resize_rect.h } )
-                                .lineto( { resize_rect.x + resize_rect.w, resize_rect.y } )
-                                .lineto( { resize_rect.x, resize_rect.y + resize_rect.h } )
-                                .closepath();
-                        } );
-                    }
-                    if ( ( flags & xui::window_flag::WINDOW_NO_TITLEBAR ) == 0 )
+            draw_style_element( "arrow", [&]()
+            {
+                xui::rect arrow_rect = {};
+
+                switch ( dir )
+                {
+                case xui::direction::LEFT_RIGHT:
+                case xui::direction::RIGHT_LEFT:
+                    // left
+                    draw_control_id( ctl_id.child( "arrow" ).child( "left" ), [&]()
                     {
-                        draw_style_element( "titlebar", [&]()
+                        arrow_rect = { back_rect.x, back_rect.y, arrow_radius, arrow_radius };
+                        draw_viewport( arrow_rect, [&]()
                         {
-                            wrect.y += XUI_SCALE( 30 );
-                            wrect.h -= XUI_SCALE( 30 );
-
-                            draw_rect( title_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-
-                            draw_image( icon_id, { XUI_SCALE( 8 ), XUI_SCALE( 5 ), XUI_SCALE( 20 ), XUI_SCALE( 20 ) } );
-
-                            draw_style_element( "title", [&]()
-                            {
-                                draw_text( title, current_font_id(), { XUI_SCALE( 30 ), XUI_SCALE( 5 ), wrect.w - XUI_SCALE( 150 ), XUI_SCALE( 20 ) }, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
-                            } );
+                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
 
-                            xui::rect box_rect = { title_rect.w, title_rect.y, XUI_SCALE( 50 ), title_rect.h };
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( value + ( dir == xui::direction::LEFT_RIGHT ? -step : step ), min, max );
 
-                            draw_control_id( std::format( "{}_{}", current_control_id(), "closebox" ), [&]()
+                            draw_style_status( status, [&]()
                             {
-                                draw_style_element( "closebox", [&]()
-                                {
-                                    box_rect.x -= XUI_SCALE( 50 );
-
-                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_CLOSEBOX ) != 0, [&]()
-                                    {
-                                        draw_viewport( box_rect, [&]()
-                                        {
-                                            xui::event_status status = current_event_status();
-                                            draw_style_status( status, [&]()
-                                            {
-                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-
-                                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                                    .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                    .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                    .closepath()
-                                                    .moveto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                    .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                    .closepath();
-                                            } );
+                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-                                            if ( status == xui::event_status::ACTIVE ) _p->_impl->remove_window( wid );
-                                        } );
-                                    } );
-                                } );
+                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.5f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.3f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.7f } )
+                                    .closepath();
                             } );
+                        } );
+                    } );
 
-                            draw_control_id( std::format( "{}_{}", current_control_id(), "maximizebox" ), [&]()
-                            {
-                                draw_style_element( "maximizebox", [&]()
-                                {
-                                    box_rect.x -= XUI_SCALE( 50 );
-
-                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_MAXIMIZEBOX ) != 0, [&]()
-                                    {
-                                        draw_viewport( box_rect, [&]()
-                                        {
-                                            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
-                                            draw_style_status( status, [&]()
-                                            {
-                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-
-                                                if ( ( window_status & xui::window_status::WINDOW_MAXIMIZE ) != 0 )
-                                                {
-                                                    draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                                        .moveto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y + XUI_SCALE( 3 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 3 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .closepath()
-                                                        .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 3 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 3 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 3 ), box_rect.center().y - XUI_SCALE( 3 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 3 ) } )
-                                                        .closepath();
-                                                }
-                                                else
-                                                {
-                                                    draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                                        .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y + XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .lineto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y - XUI_SCALE( 5 ) } )
-                                                        .closepath();
-                                                }
-                                            } );
+                    // right
+                    draw_control_id( ctl_id.child( "arrow" ).child( "right" ), [&]()
+                    {
+                        arrow_rect = { back_rect.x + back_rect.w - arrow_radius, back_rect.y, arrow_radius, arrow_radius };
+                        draw_viewport( arrow_rect, [&]()
+                        {
+                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
 
-                                            if ( status == xui::event_status::ACTIVE )
-                                            {
-                                                _p->_impl->set_window_status( wid, ( ( window_status & xui::window_status::WINDOW_MAXIMIZE ) != 0 ) ? xui::window_status::WINDOW_RESTORE : xui::window_status::WINDOW_MAXIMIZE );
-                                            }
-                                        } );
-                                    } );
-                                } );
-                            } );
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( value + ( dir == xui::direction::RIGHT_LEFT ? -step : step ), min, max );
 
-                            draw_control_id( std::format( "{}_{}", current_control_id(), "minimizebox" ), [&]()
+                            draw_style_status( status, [&]()
                             {
-                                draw_style_element( "minimizebox", [&]()
-                                {
-                                    box_rect.x -= XUI_SCALE( 50 );
-
-                                    draw_disable( ( flags & xui::window_flag::WINDOW_NO_MINIMIZEBOX ) != 0, [&]()
-                                    {
-                                        draw_viewport( box_rect, [&]()
-                                        {
-                                            xui::event_status status = current_event_status();
-                                            draw_style_status( status, [&]()
-                                            {
-                                                draw_rect( box_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-
-                                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                                    .moveto( { box_rect.center().x - XUI_SCALE( 5 ), box_rect.center().y } )
-                                                    .lineto( { box_rect.center().x + XUI_SCALE( 5 ), box_rect.center().y } )
-                                                    .closepath();
-                                            } );
+                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-                                            if ( status == xui::event_status::ACTIVE ) _p->_impl->set_window_status( wid, xui::window_status::WINDOW_MINIMIZE );
-                                        } );
-                                    } );
-                                } );
+                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.5f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.3f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.7f } )
+                                    .closepath();
                             } );
                         } );
-                    }
-                } );
-            } );
+                    } );
+                    break;
+                case xui::direction::TOP_BOTTOM:
+                case xui::direction::BOTTOM_TOP:
+                    // up
+                    draw_control_id( ctl_id.child( "arrow" ).child( "up" ), [&]()
+                    {
+                        arrow_rect = { back_rect.x, back_rect.y, arrow_radius, arrow_radius };
+                        draw_viewport( arrow_rect, [&]()
+                        {
+                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
 
-            push_viewport( wrect );
-        }
-    } );
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( value + ( dir == xui::direction::TOP_BOTTOM ? -step : step ), min, max );
 
-    return ( ( window_status & xui::window_status::WINDOW_SHOW ) != 0 );
-}
+                            draw_style_status( status, [&]()
+                            {
+                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-void xui::context::end_window()
-{
-    pop_viewport();
+                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.5f, arrow_rect.y + arrow_rect.h * 0.3f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.7f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.7f } )
+                                    .closepath();
+                            } );
+                        } );
+                    } );
 
-    auto id = current_window_id();
-    auto wrect = current_viewport();
+                    // down
+                    draw_control_id( ctl_id.child( "arrow" ).child( "down" ), [&]()
+                    {
+                        arrow_rect = { back_rect.x, back_rect.y + back_rect.h - arrow_radius, arrow_radius, arrow_radius };
+                        draw_viewport( arrow_rect, [&]()
+                        {
+                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
 
-    if ( !get_act_control_id().empty() && _p->_impl->get_event( id, xui::event::KEY_MOUSE_LEFT ) == 0 )
-    {
-        set_act_control_id( {} );
-    }
-    if ( get_act_control_id().empty() && wrect.contains( _p->_impl->get_cursor_pos( id ) ) && _p->_impl->get_event( id, xui::event::WINDOW_ACTIVE ) && _p->_impl->get_event( id, xui::event::KEY_MOUSE_LEFT ) )
-    {
-        set_hot_control_id( {} );
-    }
-}
+                            if ( status == xui::event_status::ACTIVE )
+                                value = std::clamp( value + ( dir == xui::direction::BOTTOM_TOP ? -step : step ), min, max );
 
-bool xui::context::image( xui::texture_id id )
-{
-    return image( std::format( "_image_{}", _p->_ctl_id_idx++ ), id );
-}
+                            draw_style_status( status, [&]()
+                            {
+                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-bool xui::context::image( xui::control_id ctl_id, xui::texture_id id )
-{
-    draw_style_type( "image", [&]()
-    {
-        draw_control_id( ctl_id, [&]()
-        {
-            draw_image( id, current_viewport() );
+                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
+                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.5f, arrow_rect.y + arrow_rect.h * 0.7f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.3f } )
+                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.3f } )
+                                    .closepath();
+                            } );
+                        } );
+                    } );
+                    break;
+                }
+            } );
         } );
     } );
 
-    return true;
-}
-
-bool xui::context::label( std::string_view text )
-{
-    return label( std::format( "_label_{}", _p->_ctl_id_idx++ ), text );
+    return value;
 }
 
-bool xui::context::label( xui::control_id ctl_id, std::string_view text )
+bool xui::context::menu( xui::item_model * model, xui::control_id & select_id )
 {
-    draw_style_type( "label", [&]()
+    draw_zlevel( popup_z_level, [&]()
     {
-        draw_control_id( ctl_id, [&]()
+        draw_style_element( "menu", [&]()
         {
-            draw_text( text, current_font_id(), current_viewport(), current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
-        } );
-    } );
-
-    return true;
-}
+            draw_control_id( model->control_id, [&]()
+            {
+                auto rect = current_viewport();
 
-bool xui::context::radio( bool & checked )
-{
-    return radio( std::format( "_radio_{}", _p->_ctl_id_idx++ ), checked );
-}
+                auto & geo = _p->find_menu_geometry( model, {}, current_font_id() );
+                if ( !geo.valid )
+                    geo.count = model->row_count( {} );
 
-bool xui::context::radio( xui::control_id ctl_id, bool & checked )
-{
-    draw_style_type( "radio", [&]()
-    {
-        draw_control_id( ctl_id, [&]()
-        {
-            auto id = current_window_id();
-            auto rect = current_viewport();
-            float raduis = std::min( rect.w, rect.h ) / 2;
+                auto & batch = _p->fetch_rows( model, {}, 0, geo.count, menu_roles );
+                if ( !geo.valid )
+                {
+                    for ( int row = 0; row < geo.count; row++ )
+                    {
+                        float w = font_size( current_font_id(), batch.at( row, 2 ).value<std::string_view>() ).w;
+                        if ( batch.at( row, 1 ).value<xui::texture_id>( xui::invalid_texture_id ) != xui::invalid_texture_id ) w += XUI_SCALE( 30 );
+                        if ( batch.at( row, 3 ).value<bool>() ) w += XUI_SCALE( 30 );
 
-            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
-            if ( status == xui::event_status::ACTIVE )
-                checked = !checked;
+                        geo.width = std::max( geo.width, w );
+                    }
+                    geo.valid = true;
+                }
 
-            draw_style_status( status, [&]()
-            {
-                draw_circle( { rect.x + raduis, rect.y + raduis }, raduis, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-            } );
+                int count = geo.count;
+                float maxw = geo.width;
 
-            if ( checked )
-            {
-                draw_style_element( "indicator", [&]()
+                if ( count > 0 )
                 {
-                    draw_style_status( status, [&]()
+                    xui::rect list_rect = { rect.x, rect.y, maxw, count * XUI_SCALE( 30.0f ) };
+
+                    draw_rect( list_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                    for ( int row = 0; row < count; row++ )
                     {
-                        draw_circle( { rect.x + raduis, rect.y + raduis }, ( raduis * 0.7f ), current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-                    } );
-                } );
-            }
+                        xui::rect sub_item_rect = { list_rect.x, list_rect.y + row * XUI_SCALE( 30 ), list_rect.w, XUI_SCALE( 30 ) };
+                        draw_viewport( sub_item_rect, [&]()
+                        {
+                            menu_item( row, 0, {}, model, select_id );
+                        } );
+                    }
+                }
+
+                _p->_batch_depth--;
+            } );
         } );
     } );
 
-    return checked;
-}
+    if ( !select_id.empty() )
+    {
+        for ( int row = 0; model->item_exist( row, 0, {} ); ++row )
+        {
+            model->item_data( model->index( row, 0, {} ), menubar_model::IS_SELECTED, false );
+        }
 
-bool xui::context::check( bool & checked )
-{
-    return check( std::format( "_check_{}", _p->_ctl_id_idx++ ), checked );
+        if ( model->is_child( get_hot_control_id(), {} ) )
+        {
+            set_hot_control_id( {} );
+        }
+    }
+
+    return !select_id.empty();
 }
 
-bool xui::context::check( xui::control_id ctl_id, bool & checked )
+bool xui::context::menu_item( int row, int col, xui::control_id parent, xui::item_model * model, xui::control_id & select_id )
 {
-    draw_style_type( "check", [&]()
+    // the popup drawing this item fetched its rows into the innermost batch
+    const auto & batch = _p->_batches[_p->_batch_depth - 1];
+    auto id = batch.at( row, 0 ).value<xui::control_id>();
+    auto icon = batch.at( row, 1 ).value<xui::texture_id>( xui::invalid_texture_id );
+    auto name = batch.at( row, 2 ).value<std::string_view>();
+    auto menu = batch.at( row, 3 ).value<bool>();
+    auto select = batch.at( row, 4 ).value<bool>();
+
+    draw_zlevel( popup_z_level, [&]()
     {
-        draw_control_id( ctl_id, [&]()
+        draw_style_element( "item", [&]()
         {
-            auto id = current_window_id();
-            auto rect = current_viewport();
-            rect.w = std::min( rect.w, rect.h );
-            rect.h = rect.w;
-
-            xui::event_status status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
-            if ( status == xui::event_status::ACTIVE ) checked = !checked;
-
-            draw_style_status( status, [&]()
+            draw_control_id( id, [&]()
             {
-                draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-            } );
+                auto rect = current_viewport();
 
-            if ( checked )
-            {
-                draw_style_element( "indicator", [&]()
+                draw_viewport( rect, [&]()
                 {
+                    auto aid = get_act_control_id();
+                    auto hid = get_hot_control_id();
+                    xui::event_status status = xui::event_status::NORMAL;
+
+                    if ( select && ( aid == id || hid == id || model->is_child( hid, id ) ) )
+                        status = xui::event_status::ACTIVE;
+                    else
+                        status = current_event_status( menu );
+
+                    model->item_data( id, menu_model::IS_SELECTED, ( select = ( menu && status == xui::event_status::ACTIVE ) ) );
+
                     draw_style_status( status, [&]()
                     {
-                        draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                            .moveto( { rect.x + ( rect.w * 0.2f ), rect.y + ( rect.h * 0.5f ) } )
-                            .lineto( { rect.x + ( rect.w * 0.4f ), rect.y + ( rect.h * 0.7f ) } )
-                            .lineto( { rect.x + ( rect.w * 0.8f ), rect.y + ( rect.h * 0.2f ) } );
+                        draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                        if ( icon != xui::invalid_texture_id )
+                        {
+                            draw_image( icon, { rect.x, rect.y, rect.h, rect.h } );
+                            rect = rect.margins_added( rect.h, 0, 0, 0 );
+                        }
+
+                        if ( name.empty() == false )
+                        {
+                            draw_text( name, current_font_id(), rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                        }
+
+                        if ( menu )
+                        {
+                            draw_path( current_style( "stroke", xui::stroke() ), {} )
+                                .moveto( { rect.x + rect.w - rect.h * 0.3f, rect.y + rect.h * 0.6f } )
+                                .lineto( { rect.x + rect.w - rect.h * 0.1f, rect.y + rect.h * 0.5f } )
+                                .lineto( { rect.x + rect.w - rect.h * 0.3f, rect.y + rect.h * 0.4f } )
+                                .closepath();
+                        }
                     } );
+
+                    if ( menu == false && status == xui::event_status::ACTIVE )
+                    {
+                        select_id = id;
+                    }
                 } );
-            }
+            } );
         } );
-    } );
-
-    return checked;
-}
 
-bool xui::context::button( std::string_view text )
-{
-    return button( std::format( "_button_{}", _p->_ctl_id_idx++ ), text );
-}
+        if ( menu && select )
+        {
+            auto & geo = _p->find_menu_geometry( model, id, current_font_id() );
+            if ( !geo.valid )
+                geo.count = model->row_count( id );
 
-bool xui::context::button( xui::control_id ctl_id, std::string_view text )
-{
-    xui::event_status status;
+            auto & sub_batch = _p->fetch_rows( model, id, 0, geo.count, menu_roles );
+            if ( !geo.valid )
+            {
+                for ( int row = 0; row < geo.count; row++ )
+                {
+                    float w = font_size( current_font_id(), sub_batch.at( row, 2 ).value<std::string_view>() ).w;
+                    if ( sub_batch.at( row, 1 ).value<xui::texture_id>( xui::invalid_texture_id ) != xui::invalid_texture_id ) w += XUI_SCALE( 30 );
+                    if ( sub_batch.at( row, 3 ).value<bool>() ) w += XUI_SCALE( 30 );
 
-    draw_style_type( "button", [&]()
-    {
-        draw_control_id( ctl_id, [&]()
-        {
-            auto id = current_window_id();
-            auto rect = current_viewport();
+                    geo.width = std::max( geo.width, w );
+                }
+                geo.valid = true;
+            }
 
-            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+            int count = geo.count;
+            float maxw = geo.width;
 
-            draw_style_status( status, [&]()
+            if ( count > 0 )
             {
-                draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-            } );
+                auto rect = current_viewport();
 
-            if ( !text.empty() )
-            {
-                draw_style_element( "text", [&]()
+                xui::rect list_rect = { rect.x + rect.w, rect.y, maxw, count * XUI_SCALE( 30.0f ) };
+
+                draw_rect( list_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+                for ( int row = 0; row < count; row++ )
                 {
-                    draw_style_status( status, [&]()
+                    xui::rect sub_item_rect = { list_rect.x, list_rect.y + row * XUI_SCALE( 30 ), list_rect.w, XUI_SCALE( 30 ) };
+                    draw_viewport( sub_item_rect, [&]()
                     {
-                        draw_text( text, current_font_id(), rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                        menu_item( row, 0, id, model, select_id );
                     } );
-                } );
+                }
             }
-        } );
-    } );
 
-    return status == xui::event_status::ACTIVE;
-}
+            _p->_batch_depth--;
+        }
+    } );
 
-float xui::context::slider( float & value, float min, float max )
-{
-    return slider( std::format( "_slider_{}", _p->_ctl_id_idx++ ), value, min, max );
+    return !select_id.empty();
 }
 
-float xui::context::slider( xui::control_id ctl_id, float & value, float min, float max )
+bool xui::context::menubar( xui::item_model * model, xui::control_id & select_id )
 {
-    draw_style_type( "slider", [&]()
+    draw_zlevel( popup_z_level, [&]()
     {
-        draw_control_id( ctl_id, [&]()
+        draw_style_type( "menubar", [&]()
         {
-            auto id = current_window_id();
-            auto back_rect = current_viewport();
-            xui::vec2 pos = _p->_impl->get_cursor_pos( id );
-            xui::event_status status = current_event_status();
-
-            draw_style_status( status, [&]()
-            {
-                draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-            } );
-
-            draw_style_element( "cursor", [&]()
+            draw_control_id( model->control_id, [&]()
             {
-                float cursor_w = 0;
-                float cursor_h = 0;
-                float cursor_step = 0;
-                xui::rect cursor_rect = {};
-                float backleft = back_rect.x;
-                float backright = back_rect.x + back_rect.w;
-                float backtop = back_rect.y;
-                float backbottom = back_rect.y + back_rect.h;
+                auto rect = current_viewport();
+                xui::rect menubar_rect = { rect.x, rect.y - 1, rect.w, XUI_SCALE( 30 ) };
 
-                switch ( current_style( "direction" ).value<xui::direction>( xui::direction::LEFT_RIGHT ) )
-                {
-                case xui::direction::LEFT_RIGHT:
+                draw_viewport( menubar_rect, [&]()
                 {
-                    backleft += XUI_SCALE( 5 );
-                    backright -= XUI_SCALE( 5 );
-                    cursor_w = XUI_SCALE( 10.0f );
-                    cursor_h = backbottom - backtop;
-                    cursor_step = ( backright - backleft ) / ( max - min );
-                    if ( status == xui::event_status::ACTIVE )
-                        value = std::clamp( ( ( pos.x - backleft ) / ( backright - backleft ) ) * ( max - min ), min, max );
+                    draw_rect( menubar_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-                    cursor_rect = {
-                        back_rect.x + ( cursor_step * value ),
-                        back_rect.y,
-                        cursor_w,
-                        cursor_h
-                    };
-                    break;
-                }
-                case xui::direction::RIGHT_LEFT:
-                {
-                    backleft += XUI_SCALE( 5 );
-                    backright -= XUI_SCALE( 5 );
-                    cursor_w = XUI_SCALE( 10.0f );
-                    cursor_h = backbottom - backtop;
-                    cursor_step = ( backright - backleft ) / ( max - min );
-                    if ( status == xui::event_status::ACTIVE )
-                        value = std::clamp( ( ( backright - pos.x ) / ( backright - backleft ) ) * ( max - min ), min, max );
+                    static constexpr int roles[] = { menubar_model::ID, menubar_model::ICON, menubar_model::NAME, menubar_model::IS_SELECTED, menubar_model::MENUMODEL };
 
-                    cursor_rect = {
-                        ( back_rect.x + back_rect.w - cursor_w ) - ( cursor_step * value ),
-                        back_rect.y,
-                        cursor_w,
-                        cursor_h
-                    };
-                    break;
-                }
-                case xui::direction::TOP_BOTTOM:
-                {
-                    backtop += XUI_SCALE( 5 );
-                    backbottom -= XUI_SCALE( 5 );
-                    cursor_w = backright - backleft;
-                    cursor_h = XUI_SCALE( 10.0f );
-                    cursor_step = ( backbottom - backtop ) / ( max - min );
-                    if ( status == xui::event_status::ACTIVE )
-                        value = std::clamp( ( ( pos.y - backtop ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+                    int count = model->col_count( {} );
+                    auto & batch = _p->fetch_rows( model, {}, 0, count, roles );
 
-                    cursor_rect = {
-                        back_rect.x,
-                        back_rect.y + ( cursor_step * value ),
-                        cursor_w,
-                        cursor_h
-                    };
-                    break;
-                }
-                case xui::direction::BOTTOM_TOP:
-                {
-                    backtop += XUI_SCALE( 5 );
-                    backbottom -= XUI_SCALE( 5 );
-                    cursor_w = backright - backleft;
-                    cursor_h = XUI_SCALE( 10.0f );
-                    cursor_step = ( backbottom - backtop ) / ( max - min );
-                    if ( status == xui::event_status::ACTIVE )
-                        value = std::clamp( ( ( backbottom - pos.y ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+                    for ( int row = 0; row < count; row++ )
+                    {
+                        auto id = batch.at( row, 0 ).value<xui::control_id>();
+                        auto icon = batch.at( row, 1 ).value<xui::texture_id>( xui::invalid_texture_id );
+                        auto name = batch.at( row, 2 ).value<std::string_view>();
+                        auto select = batch.at( row, 3 ).value<bool>();
+                        auto menu_model = batch.at( row, 4 ).value<xui::item_model *>();
 
-                    cursor_rect = {
-                        back_rect.x,
-                        ( back_rect.y + back_rect.h - cursor_h ) - ( cursor_step * value ),
-                        cursor_w,
-                        cursor_h
-                    };
-                    break;
-                }
-                }
+                        auto name_size = font_size( current_font_id(), name );
+                        xui::rect item_rect = { menubar_rect.x, menubar_rect.y, 0, 30 };
 
-                draw_style_status( status, [&]()
-                {
-                    draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-                } );
-            } );
-        } );
-    } );
+                        if ( icon != xui::invalid_texture_id )
+                            item_rect.w += item_rect.h;
 
-    return value;
-}
+                        item_rect.w += name_size.w;
 
-bool xui::context::process( float value, float min, float max, std::string_view text )
-{
-    return process( std::format( "_process_{}", _p->_ctl_id_idx++ ), value, min, max, text );
-}
+                        draw_control_id( id, [&]()
+                        {
+                            draw_viewport( item_rect, [&]()
+                            {
+                                auto aid = get_act_control_id();
+                                auto hid = get_hot_control_id();
+                                xui::event_status status = xui::event_status::NORMAL;
 
-bool xui::context::process( xui::control_id ctl_id, float value, float min, float max, std::string_view text )
-{
-    draw_style_type( "process", [&]()
-    {
-        draw_control_id( ctl_id, [&]()
-        {
-            auto back_rect = current_viewport();
+                                if ( select && ( aid == id || hid == id || model->is_child( hid, id ) ) )
+                                    status = xui::event_status::ACTIVE;
+                                else
+                                    status = current_event_status( true );
 
-            draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+                                model->item_data( id, menubar_model::IS_SELECTED, ( select = ( status == xui::event_status::ACTIVE ) ) );
 
-            draw_style_element( "cursor", [&]()
-            {
-                xui::rect cursor_rect;
-                value = ( value - min ) / ( max - min );
+                                draw_style_status( status, [&]()
+                                {
+                                    draw_rect( item_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-                switch ( current_style( "direction" ).value<xui::direction>( xui::direction::LEFT_RIGHT ) )
-                {
-                case xui::direction::LEFT_RIGHT:
-                    cursor_rect = { back_rect.x, back_rect.y, back_rect.w * value, back_rect.h };
-                    break;
-                case xui::direction::RIGHT_LEFT:
-                    cursor_rect = { back_rect.x + ( back_rect.w - ( back_rect.w * value ) ), back_rect.y, back_rect.w * value, back_rect.h };
-                    break;
-                case xui::direction::TOP_BOTTOM:
-                    cursor_rect = { back_rect.x, back_rect.y, back_rect.w, back_rect.h * value };
-                    break;
-                case xui::direction::BOTTOM_TOP:
-                    cursor_rect = { back_rect.x, back_rect.y + ( back_rect.h - ( back_rect.h * value ) ), back_rect.w, back_rect.h * value };
-                    break;
-                default:
-                    break;
-                }
+                                    float x = item_rect.x;
 
-                draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-            } );
+                                    if ( icon != xui::invalid_texture_id )
+                                    {
+                                        draw_image( icon, { x, item_rect.y, item_rect.h, item_rect.h } );
+                                        x += item_rect.h;
+                                    }
 
-            if ( !text.empty() )
-            {
-                draw_style_element( "text", [&]()
-                {
-                    draw_text( text, current_font_id(), back_rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                                    draw_text( name, current_font_id(), { x, item_rect.y, name_size.w, item_rect.h }, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
+                                } );
+                            } );
+                        } );
+
+                        if ( select )
+                            draw_viewport( { item_rect.x, item_rect.y + item_rect.h, rect.w - ( item_rect.x - rect.x ), rect.h }, [&]()
+                        {
+                            menu( menu_model, select_id );
+                        } );
+
+                        menubar_rect = menubar_rect.margins_added( item_rect.w, 0, 0, 0 );
+                    }
+
+                    _p->_batch_depth--;
                 } );
-            }
+
+                push_viewport( rect.margins_added( 0, 0, XUI_SCALE( 30 ), 0 ) );
+            } );
         } );
     } );
 
-    return true;
+    if ( !select_id.empty() )
+    {
+        for ( int row = 0; model->item_exist( row, 0, {} ); ++row )
+        {
+            model->item_data( model->index( row, 0, {} ), menubar_model::IS_SELECTED, false );
+        }
+
+        if ( model->is_child( get_hot_control_id(), {} ) )
+        {
+            set_hot_control_id( {} );
+        }
+    }
+
+    return !select_id.empty();
 }
 
-float xui::context::scrollbar( float & value, float step, float min, float max, xui::direction dir )
+bool xui::context::begin_horizontal_layout( std::span<int> stretch, xui::layout_direction dir )
 {
-    return scrollbar( std::format( "_scrollbar_{}", _p->_ctl_id_idx++ ), value, step, min, max, dir );
+    return begin_horizontal_layout( current_control_id().child( _p->_ctl_id_idx++ ), stretch, dir );
 }
 
-float xui::context::scrollbar( xui::control_id ctl_id, float & value, float step, float min, float max, xui::direction dir )
+bool xui::context::begin_horizontal_layout( xui::control_id ctl_id, std::span<int> stretch, xui::layout_direction dir )
 {
-    draw_style_type( "scrollbar", [&]()
+    layout_params params;
+
+    draw_style_type( "layout", [&]()
     {
-        draw_control_id( ctl_id, [&]()
-        {
-            auto id = current_window_id();
-            auto back_rect = current_viewport();
-            xui::vec2 pos = _p->_impl->get_cursor_pos( id );
-            float arrow_radius = std::min( back_rect.w, back_rect.h );
-            xui::event_status status;
+        auto padding = current_style( "padding", xui::vec4() );
+
+        params.kind = LAYOUT_HORIZONTAL;
+        params.rect = current_viewport().margins_added( XUI_SCALE( padding.x ), XUI_SCALE( -padding.z ), XUI_SCALE( padding.y ), XUI_SCALE( -padding.w ) );
+        params.spacing = XUI_SCALE( current_style( "spacing", 0.0f ) );
+        params.wrap = current_style( "flex-wrap", xui::layout_wrap::LAYOUT_NO_WRAP );
+        params.justify = layout_align_value( current_style( "justify-content", (std::uint32_t)xui::layout_align::LAYOUT_START ), xui::layout_align::LAYOUT_START );
+        params.align = layout_align_value( current_style( "align-items", (std::uint32_t)xui::layout_align::LAYOUT_STRETCH ), xui::layout_align::LAYOUT_STRETCH );
+        params.dir = dir;
+    } );
 
-            draw_rect( back_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    _p->begin_layout( ctl_id, params, stretch );
 
-            draw_style_element( "cursor", [&]()
-            {
-                draw_control_id( std::format( "{}-{}", ctl_id, "cursor" ), [&]()
-                {
-                    std::string_view element;
+    return params.rect.w > 0 && params.rect.h > 0;
+}
 
-                    float cursor_w = 0;
-                    float cursor_h = 0;
-                    float cursor_step = 0;
-                    xui::rect cursor_rect = {};
-                    xui::rect detect_rect = {};
+void xui::context::end_horizontal_layout()
+{
+    _p->end_layout();
+}
 
-                    switch ( dir )
-                    {
-                    case xui::direction::LEFT_RIGHT:
-                    case xui::direction::RIGHT_LEFT:
-                        detect_rect = { back_rect.x + arrow_radius,  back_rect.y, back_rect.w - arrow_radius * 2, back_rect.h };
-                        break;
-                    case xui::direction::TOP_BOTTOM:
-                    case xui::direction::BOTTOM_TOP:
-                        detect_rect = { back_rect.x,  back_rect.y + arrow_radius, back_rect.w, back_rect.h - arrow_radius * 2 };
-                        break;
-                    default:
-                        break;
-                    }
+bool xui::context::begin_vertical_layout( std::span<int> stretch, xui::layout_direction dir )
+{
+    return begin_vertical_layout( current_control_id().child( _p->_ctl_id_idx++ ), stretch, dir );
+}
 
-                    draw_viewport( detect_rect, [&]()
-                    {
-                        status = current_event_status();
+bool xui::context::begin_vertical_layout( xui::control_id ctl_id, std::span<int> stretch, xui::layout_direction dir )
+{
+    layout_params params;
+
+    draw_style_type( "layout", [&]()
+    {
+        auto padding = current_style( "padding", xui::vec4() );
+
+        params.kind = LAYOUT_VERTICAL;
+        params.rect = current_viewport().margins_added( XUI_SCALE( padding.x ), XUI_SCALE( -padding.z ), XUI_SCALE( padding.y ), XUI_SCALE( -padding.w ) );
+        params.spacing = XUI_SCALE( current_style( "spacing", 0.0f ) );
+        params.wrap = current_style( "flex-wrap", xui::layout_wrap::LAYOUT_NO_WRAP );
+        params.justify = layout_align_value( current_style( "justify-content", (std::uint32_t)xui::layout_align::LAYOUT_START ), xui::layout_align::LAYOUT_START );
+        params.align = layout_align_value( current_style( "align-items", (std::uint32_t)xui::layout_align::LAYOUT_STRETCH ), xui::layout_align::LAYOUT_STRETCH );
+        params.dir = dir;
+    } );
+
+    _p->begin_layout( ctl_id, params, stretch );
+
+    return params.rect.w > 0 && params.rect.h > 0;
+}
 
-                        float backleft = detect_rect.x;
-                        float backright = detect_rect.x + detect_rect.w;
-                        float backtop = detect_rect.y;
-                        float backbottom = detect_rect.y + detect_rect.h;
+void xui::context::end_vertical_layout()
+{
+    _p->end_layout();
+}
 
-                        switch ( dir )
-                        {
-                        case xui::direction::LEFT_RIGHT:
-                        {
-                            backleft += arrow_radius;
-                            backright -= arrow_radius;
-                            cursor_w = arrow_radius * 2;
-                            cursor_h = backbottom - backtop;
-                            cursor_step = ( backright - backleft ) / ( max - min );
+bool xui::context::begin_grid_layout( int columns )
+{
+    return begin_grid_layout( current_control_id().child( _p->_ctl_id_idx++ ), columns );
+}
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( ( ( pos.x - backleft ) / ( backright - backleft ) ) * ( max - min ), min, max );
+bool xui::context::begin_grid_layout( xui::control_id ctl_id, int columns )
+{
+    layout_params params;
 
-                            cursor_rect = {
-                                backleft + ( cursor_step * value ) - ( cursor_w * 0.5f ),
-                                backtop,
-                                cursor_w,
-                                cursor_h
-                            };
-                            element = "horizontal";
-                            break;
-                        }
-                        case xui::direction::RIGHT_LEFT:
-                        {
-                            backleft += arrow_radius;
-                            backright -= arrow_radius;
-                            cursor_w = arrow_radius * 2;
-                            cursor_h = backbottom - backtop;
-                            cursor_step = ( backright - backleft ) / ( max - min );
+    draw_style_type( "layout", [&]()
+    {
+        auto padding = current_style( "padding", xui::vec4() );
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( ( ( backright - pos.x ) / ( backright - backleft ) ) * ( max - min ), min, max );
+        params.kind = LAYOUT_GRID;
+        params.rect = current_viewport().margins_added( XUI_SCALE( padding.x ), XUI_SCALE( -padding.z ), XUI_SCALE( padding.y ), XUI_SCALE( -padding.w ) );
+        params.spacing = XUI_SCALE( current_style( "spacing", 0.0f ) );
+        params.columns = columns > 0 ? columns : current_style( "columns", 1 );
+    } );
 
-                            cursor_rect = {
-                                ( backleft + ( backright - backleft ) ) - ( cursor_step * value ) - ( cursor_w * 0.5f ),
-                                backtop,
-                                cursor_w,
-                                cursor_h
-                            };
+    _p->begin_layout( ctl_id, params, {} );
 
-                            element = "horizontal";
-                            break;
-                        }
-                        case xui::direction::TOP_BOTTOM:
-                        {
-                            backtop += arrow_radius;
-                            backbottom -= arrow_radius;
-                            cursor_w = backright - backleft;
-                            cursor_h = arrow_radius * 2;
-                            cursor_step = ( backbottom - backtop ) / ( max - min );
+    return params.rect.w > 0 && params.rect.h > 0;
+}
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( ( ( pos.y - backtop ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+void xui::context::end_grid_layout()
+{
+    _p->end_layout();
+}
 
-                            cursor_rect = {
-                                backleft,
-                                backtop + ( cursor_step * value ) - ( cursor_h * 0.5f ),
-                                cursor_w,
-                                cursor_h
-                            };
+xui::rect xui::context::next_layout_item( const xui::size & hint )
+{
+    if ( _p->_layouts.empty() )
+        return current_viewport();
 
-                            element = "vertical";
-                            break;
-                        }
-                        case xui::direction::BOTTOM_TOP:
-                        {
-                            backtop += arrow_radius;
-                            backbottom -= arrow_radius;
-                            cursor_w = backright - backleft;
-                            cursor_h = arrow_radius * 2;
-                            cursor_step = ( backbottom - backtop ) / ( max - min );
+    return _p->next_layout_item( { XUI_SCALE( hint.w ), XUI_SCALE( hint.h ) } );
+}
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( ( ( backbottom - pos.y ) / ( backbottom - backtop ) ) * ( max - min ), min, max );
+bool xui::context::begin_listview( xui::listview_model * model )
+{
+    return begin_listview( current_control_id().child( _p->_ctl_id_idx++ ), model );
+}
 
-                            cursor_rect = {
-                                backleft,
-                                ( backtop + ( backbottom - backtop ) ) - ( cursor_step * value ) - ( cursor_h * 0.5f ),
-                                cursor_w,
-                                cursor_h
-                            };
+bool xui::context::begin_listview( xui::control_id ctl_id, xui::listview_model * model )
+{
+    bool result = false;
 
-                            element = "vertical";
-                            break;
-                        }
-                        }
+    if ( !is_visible( current_viewport() ) )
+    {
+        _p->_itemviews.emplace_back().list = model;
+        _p->use( _p->_itemview_states[ctl_id.hash()].used );
+        return false;
+    }
 
-                        draw_style_element( element, [&]()
-                        {
-                            draw_style_status( status, [&]()
-                            {
-                                draw_rect( cursor_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
-                            } );
-                        } );
-                    } );
-                } );
-            } );
+    draw_style_type( "listview", [&]()
+    {
+        auto & view = _p->_itemviews.emplace_back();
 
-            draw_style_element( "arrow", [&]()
-            {
-                xui::rect arrow_rect = {};
+        view.list = model;
+        if ( model->uniform_rows() )
+            view.uniform = model->row_height( 0 ) > 0 ? model->row_height( 0 ) : current_style( "item-height", 24.0f );
 
-                switch ( dir )
-                {
-                case xui::direction::LEFT_RIGHT:
-                case xui::direction::RIGHT_LEFT:
-                    // left
-                    draw_control_id( std::format( "{}-{}-{}", ctl_id, "arrow", "left" ), [&]()
-                    {
-                        arrow_rect = { back_rect.x, back_rect.y, arrow_radius, arrow_radius };
-                        draw_viewport( arrow_rect, [&]()
-                        {
-                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+        result = begin_itemview( ctl_id, model->row_count( {} ) );
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( value + ( dir == xui::direction::LEFT_RIGHT ? -step : step ), min, max );
+        if ( result && !model->is_item_custom() )
+        {
+            static constexpr int roles[] = { xui::listview_model::NAME };
 
-                            draw_style_status( status, [&]()
-                            {
-                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+            view.first = view.row;
+            view.batch = &_p->fetch_rows( model, {}, view.row, view.end - view.row, roles );
+        }
+    } );
 
-                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.5f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.3f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.7f } )
-                                    .closepath();
-                            } );
-                        } );
-                    } );
+    return result;
+}
 
-                    // right
-                    draw_control_id( std::format( "{}-{}-{}", ctl_id, "arrow", "right" ), [&]()
-                    {
-                        arrow_rect = { back_rect.x + back_rect.w - arrow_radius, back_rect.y, arrow_radius, arrow_radius };
-                        draw_viewport( arrow_rect, [&]()
-                        {
-                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+bool xui::context::listview_item( int & row )
+{
+    auto & view = _p->_itemviews.back();
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( value + ( dir == xui::direction::RIGHT_LEFT ? -step : step ), min, max );
+    if ( !next_itemview_row( row, view.list->row_count( {} ) ) )
+        return false;
 
-                            draw_style_status( status, [&]()
-                            {
-                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    auto id = view.list->index( row, 0, {} );
+    auto status = itemview_item( row, id, view.list, xui::listview_model::IS_SELECTED );
+    auto rect = current_viewport();
 
-                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.5f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.3f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.7f } )
-                                    .closepath();
-                            } );
-                        } );
-                    } );
-                    break;
-                case xui::direction::TOP_BOTTOM:
-                case xui::direction::BOTTOM_TOP:
-                    // up
-                    draw_control_id( std::format( "{}-{}-{}", ctl_id, "arrow", "up" ), [&]()
-                    {
-                        arrow_rect = { back_rect.x, back_rect.y, arrow_radius, arrow_radius };
-                        draw_viewport( arrow_rect, [&]()
-                        {
-                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+    if ( view.list->is_item_custom() )
+    {
+        view.list->draw_item( this, rect );
+    }
+    else
+    {
+        if ( auto str = std::get_if<std::string_view>( &view.batch->at( row - view.first, 0 ) ) )
+            draw_text( *str, current_font_id(), rect, view.colors[status], view.align );
+    }
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( value + ( dir == xui::direction::TOP_BOTTOM ? -step : step ), min, max );
+    return true;
+}
 
-                            draw_style_status( status, [&]()
-                            {
-                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+void xui::context::end_listview()
+{
+    end_itemview();
+}
 
-                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.5f, arrow_rect.y + arrow_rect.h * 0.3f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.7f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.7f } )
-                                    .closepath();
-                            } );
-                        } );
-                    } );
+bool xui::context::begin_treeview( xui::treeview_model * model )
+{
+    return begin_treeview( current_control_id().child( _p->_ctl_id_idx++ ), model );
+}
 
-                    // down
-                    draw_control_id( std::format( "{}-{}-{}", ctl_id, "arrow", "down" ), [&]()
-                    {
-                        arrow_rect = { back_rect.x, back_rect.y + back_rect.h - arrow_radius, arrow_radius, arrow_radius };
-                        draw_viewport( arrow_rect, [&]()
-                        {
-                            status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+bool xui::context::begin_treeview( xui::control_id ctl_id, xui::treeview_model * model )
+{
+    bool result = false;
 
-                            if ( status == xui::event_status::ACTIVE )
-                                value = std::clamp( value + ( dir == xui::direction::BOTTOM_TOP ? -step : step ), min, max );
+    if ( !is_visible( current_viewport() ) )
+    {
+        _p->_itemviews.emplace_back().tree = model;
+        _p->use( _p->_itemview_states[ctl_id.hash()].used );
+        return false;
+    }
 
-                            draw_style_status( status, [&]()
-                            {
-                                draw_rect( arrow_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    draw_style_type( "treeview", [&]()
+    {
+        auto & view = _p->_itemviews.emplace_back();
 
-                                draw_path( current_style( "stroke", xui::stroke() ), current_style( "filled", xui::filled() ) )
-                                    .moveto( { arrow_rect.x + arrow_rect.w * 0.5f, arrow_rect.y + arrow_rect.h * 0.7f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.3f, arrow_rect.y + arrow_rect.h * 0.3f } )
-                                    .lineto( { arrow_rect.x + arrow_rect.w * 0.7f, arrow_rect.y + arrow_rect.h * 0.3f } )
-                                    .closepath();
-                            } );
-                        } );
-                    } );
-                    break;
-                }
+        view.tree = model;
+        view.uniform = current_style( "item-height", 24.0f );
+        view.indent = XUI_SCALE( current_style( "indent", 16.0f ) );
+
+        draw_style_element( "item", [&]()
+        {
+            draw_style_element( "arrow", [&]()
+            {
+                view.arrow_border = current_style( "border", xui::border() );
+                view.arrow_filled = current_style( "filled", xui::filled() );
             } );
         } );
+
+        result = begin_itemview( ctl_id, (int)model->visible_nodes().size() );
+
+        if ( result && !model->is_item_custom() )
+        {
+            static constexpr int roles[] = { xui::treeview_model::NAME };
+
+            auto nodes = model->visible_nodes().subspan( view.row, view.end - view.row );
+            std::pmr::vector<xui::control_id> ids( &_p->_frame->arena );
+            ids.reserve( nodes.size() );
+            for ( const auto & it : nodes )
+                ids.push_back( it.id );
+
+            view.first = view.row;
+            view.fetched = (int)ids.size();
+            view.batch = &_p->fetch_items( model, ids, roles );
+        }
     } );
 
-    return value;
+    return result;
 }
 
-bool xui::context::menu( xui::item_model * model, xui::control_id & select_id )
+bool xui::context::treeview_item( int & row )
 {
-    draw_zlevel( popup_z_level, [&]()
+    auto & view = _p->_itemviews.back();
+
+    if ( !next_itemview_row( row, (int)view.tree->visible_nodes().size() ) )
+        return false;
+
+    auto node = view.tree->visible_nodes()[row];
+    auto status = itemview_item( row, node.id, view.tree, xui::treeview_model::IS_SELECTED );
+    auto rect = current_viewport();
+
+    float indent = view.indent * node.depth;
+    float row_h = view.uniform * _p->_factor;
+    xui::rect arrow = { rect.x + indent, rect.y, row_h, rect.h };
+    xui::rect text = { arrow.x + arrow.w, rect.y, std::max( 0.0f, rect.w - indent - arrow.w ), rect.h };
+
+    if ( view.tree->has_children( row ) )
     {
-        draw_style_element( "menu", [&]()
+        const auto & input = _p->input( current_window_id() );
+        if ( !current_disable() && input.test( xui::event::WINDOW_ACTIVE ) )
         {
-            draw_control_id( model->control_id, [&]()
+            if ( ( input.test( xui::event::KEY_MOUSE_LEFT_CLICK ) && arrow.contains( input.cursor_pos ) ) || ( input.test( xui::event::KEY_MOUSE_LEFT_DBCLICK ) && rect.contains( input.cursor_pos ) ) )
             {
-                auto rect = current_viewport();
+                view.tree->toggle( row );
+                node.expanded = !node.expanded;
 
-                int count = 0;
-                float maxw = 0;
-                while ( model->item_exist( count, 0, {} ) )
-                {
-                    auto id = model->index( count, 0, {} );
-                    auto icon = model->item_data( id, menu_model::ICON ).value<xui::texture_id>();
-                    auto name = model->item_data( id, menu_model::NAME ).value<std::string>();
-                    auto menu = model->item_data( id, menu_model::IS_MENU ).value<bool>();
-                    auto select = model->item_data( id, menu_model::IS_SELECTED ).value<bool>();
+                // the rows below moved, they read the model directly for the rest of the frame
+                view.fetched = std::min( view.fetched, row + 1 - view.first );
+            }
+        }
+
+        auto c = arrow.center();
+        float r = row_h * 0.2f;
+        std::array<xui::vec2, 3> points;
+        if ( node.expanded )
+            points = { xui::vec2{ c.x - r, c.y - r * 0.5f }, xui::vec2{ c.x + r, c.y - r * 0.5f }, xui::vec2{ c.x, c.y + r * 0.5f } };
+        else
+            points = { xui::vec2{ c.x - r * 0.5f, c.y - r }, xui::vec2{ c.x + r * 0.5f, c.y }, xui::vec2{ c.x - r * 0.5f, c.y + r } };
+
+        draw_polygon( points, view.arrow_border, view.arrow_filled );
+    }
 
+    if ( view.tree->is_item_custom() )
+    {
+        view.tree->draw_item( this, text );
+    }
+    else if ( row - view.first < view.fetched )
+    {
+        if ( auto str = std::get_if<std::string_view>( &view.batch->at( row - view.first, 0 ) ) )
+            draw_text( *str, current_font_id(), text, view.colors[status], view.align );
+    }
+    else
+    {
+        auto name = view.tree->item_data( node.id, xui::treeview_model::NAME );
+        if ( auto str = std::get_if<std::string>( &name ) )
+            draw_text( *str, current_font_id(), text, view.colors[status], view.align );
+    }
 
-                    float w = _p->_impl->font_size( current_font_id(), model->item_data( id, xui::menu_model::NAME ).value<std::string>() ).w;
-                    if ( model->item_data( id, xui::menu_model::ICON ).value<xui::texture_id>() != xui::invalid_texture_id ) w += XUI_SCALE( 30 );
-                    if ( model->item_data( id, xui::menu_model::IS_MENU ).value<bool>() ) w += XUI_SCALE( 30 );
+    return true;
+}
 
-                    maxw = std::max( maxw, w );
+void xui::context::end_treeview()
+{
+    end_itemview();
+}
 
-                    count++;
-                }
+bool xui::context::begin_tableview( xui::tableview_model * model )
+{
+    return begin_tableview( current_control_id().child( _p->_ctl_id_idx++ ), model );
+}
 
-                if ( count > 0 )
-                {
-                    xui::rect list_rect = { rect.x, rect.y, maxw, count * XUI_SCALE( 30.0f ) };
+bool xui::context::begin_tableview( xui::control_id ctl_id, xui::tableview_model * model )
+{
+    auto & state = _p->_itemview_states[ctl_id.hash()];
+    auto & view = _p->_tableviews.emplace_back();
 
-                    draw_rect( list_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    _p->use( state.used );
+    view.id = ctl_id;
+    view.state = &state;
+    view.model = model;
 
-                    for ( int row = 0; row < count; row++ )
-                    {
-                        xui::rect sub_item_rect = { list_rect.x, list_rect.y + row * XUI_SCALE( 30 ), list_rect.w, XUI_SCALE( 30 ) };
-                        draw_viewport( sub_item_rect, [&]()
-                        {
-                            menu_item( row, 0, {}, model, select_id );
-                        } );
-                    }
-                }
-            } );
-        } );
-    } );
+    if ( !is_visible( current_viewport() ) )
+        return false;
 
-    if ( !select_id.empty() )
+    draw_style_type( "tableview", [&]()
     {
-        for ( int row = 0; model->item_exist( row, 0, {} ); ++row )
+        auto rect = current_viewport();
+        auto rows = model->view_count();
+        auto cols = model->col_count( {} );
+        auto frozen = std::min( model->frozen_cols(), cols );
+
+        view.rect = rect;
+        view.item_h = XUI_SCALE( current_style( "item-height", 24.0f ) );
+        view.header_h = XUI_SCALE( current_style( "header-height", 24.0f ) );
+        view.header_w = XUI_SCALE( current_style( "header-width", 0.0f ) );
+
+        draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+
+        view.lefts.resize( cols + 1 );
+        view.lefts[0] = 0;
+        for ( int i = 0; i < cols; i++ )
+            view.lefts[i + 1] = view.lefts[i] + XUI_SCALE( model->col_width( i ) );
+        view.frozen_w = view.lefts[frozen];
+
+        float bar = XUI_SCALE( 15 );
+        double total_y = rows * (double)view.item_h;
+        float total_x = view.lefts[cols] - view.lefts[frozen];
+        float avail_w = rect.w - view.header_w - view.frozen_w, avail_h = rect.h - view.header_h;
+
+        bool need_y = total_y > avail_h;
+        bool need_x = total_x > avail_w - ( need_y ? bar : 0 );
+        need_y = need_y || ( need_x && total_y > avail_h - bar );
+
+        view.body = { rect.x + view.header_w + view.frozen_w, rect.y + view.header_h, std::max( 0.0f, avail_w - ( need_y ? bar : 0 ) ), std::max( 0.0f, avail_h - ( need_x ? bar : 0 ) ) };
+
+        // offsets are unscaled like the listview, double keeps a million rows precise
+        double range_y = std::max( 0.0, ( total_y - view.body.h ) / _p->_factor );
+        float range_x = std::max( 0.0f, ( total_x - view.body.w ) / _p->_factor );
+        float step = view.item_h / _p->_factor * 3;
+
+        const auto & input = _p->input( current_window_id() );
+        if ( rect.contains( input.cursor_pos ) )
         {
-            model->item_data( model->index( row, 0, {} ), menubar_model::IS_SELECTED, false );
+            state.offset -= input.wheel.y * step;
+            state.offset_x -= input.wheel.x * step;
         }
 
-        if ( model->is_child( get_hot_control_id(), {} ) )
+        if ( need_y )
         {
-            set_hot_control_id( {} );
+            draw_viewport( { view.body.x + view.body.w, view.body.y, bar, view.body.h }, [&]()
+            {
+                float before = (float)state.offset, value = before;
+                scrollbar( ctl_id.child( "vscrollbar" ), value, step, 0, (float)range_y, xui::direction::TOP_BOTTOM );
+                if ( value != before )
+                    state.offset += value - before;
+            } );
+        }
+        if ( need_x )
+        {
+            draw_viewport( { view.body.x, view.body.y + view.body.h, view.body.w, bar }, [&]()
+            {
+                scrollbar( ctl_id.child( "hscrollbar" ), state.offset_x, step, 0, range_x, xui::direction::LEFT_RIGHT );
+            } );
+        }
+        state.offset = std::clamp( state.offset, 0.0, range_y );
+        state.offset_x = std::clamp( state.offset_x, 0.0f, range_x );
+
+        // cells keep their full size, the frozen and scrolled clips trim them and are shared by every row
+        push_clip( { rect.x + view.header_w, view.body.y, view.frozen_w, view.body.h } );
+        view.clips[0] = _p->_clips.back();
+        pop_clip();
+        push_clip( view.body );
+        view.clips[1] = _p->_clips.back();
+        pop_clip();
+
+        // only the rows and columns intersecting the clipped body are visited
+        auto visible = intersect( view.body, current_clip() );
+        double top = state.offset * _p->_factor + ( visible.y - view.body.y );
+        if ( rows > 0 )
+        {
+            view.row = std::min( int( top / view.item_h ), rows - 1 );
+            view.row_end = std::min( int( ( top + visible.h ) / view.item_h ) + 1, rows );
         }
-    }
 
-    return !select_id.empty();
-}
+        view.cols.clear();
+        for ( int i = 0; i < frozen; i++ )
+            view.cols.push_back( i );
 
-bool xui::context::menu_item( int row, int col, xui::control_id parent, xui::item_model * model, xui::control_id & select_id )
-{
-    auto id = model->index( row, col, parent );
-    auto icon = model->item_data( id, menu_model::ICON ).value<xui::texture_id>();
-    auto name = model->item_data( id, menu_model::NAME ).value<std::string>();
-    auto menu = model->item_data( id, menu_model::IS_MENU ).value<bool>();
-    auto select = model->item_data( id, menu_model::IS_SELECTED ).value<bool>();
+        float scroll = view.lefts[frozen] + state.offset_x * _p->_factor + ( visible.x - view.body.x );
+        auto first = std::upper_bound( view.lefts.begin() + frozen, view.lefts.end(), scroll ) - view.lefts.begin() - 1;
+        for ( int i = std::max<int>( (int)first, frozen ); i < cols && view.lefts[i] < scroll + visible.w; i++ )
+            view.cols.push_back( i );
 
-    draw_zlevel( popup_z_level, [&]()
-    {
         draw_style_element( "item", [&]()
         {
-            draw_control_id( id, [&]()
+            view.align = current_style( "text-align", xui::alignment_flag::ALIGN_CENTER );
+            for ( auto status : { xui::event_status::NORMAL, xui::event_status::HOVER, xui::event_status::ACTIVE } )
             {
-                auto rect = current_viewport();
-
-                draw_viewport( rect, [&]()
+                draw_style_status( status, [&]()
                 {
-                    auto aid = get_act_control_id();
-                    auto hid = get_hot_control_id();
-                    xui::event_status status = xui::event_status::NORMAL;
+                    view.borders[status] = current_style( "border", xui::border() );
+                    view.filleds[status] = current_style( "filled", xui::filled() );
+                    view.colors[status] = current_style( "font-color", xui::color() );
+                } );
+            }
+        } );
 
-                    if ( select && ( aid == id || hid == id || model->is_child( hid, id ) ) )
-                        status = xui::event_status::ACTIVE;
-                    else
-                        status = current_event_status( menu );
+        if ( view.row < view.row_end && !view.cols.empty() && !model->is_item_custom() )
+            _p->fetch_cells( view );
+    } );
 
-                    model->item_data( id, menu_model::IS_SELECTED, ( select = ( menu && status == xui::event_status::ACTIVE ) ) );
+    return view.row < view.row_end && !view.cols.empty();
+}
 
-                    draw_style_status( status, [&]()
-                    {
-                        draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+void xui::context::tableview_header()
+{
+    auto & view = _p->_tableviews.back();
+    auto model = view.model;
+    auto frozen = std::min( model->frozen_cols(), model->col_count( {} ) );
 
-                        if ( icon != xui::invalid_texture_id )
-                        {
-                            draw_image( icon, { rect.x, rect.y, rect.h, rect.h } );
-                            rect = rect.margins_added( rect.h, 0, 0, 0 );
-                        }
+    draw_style_type( "tableview", [&]()
+    {
+        draw_style_element( "header", [&]()
+        {
+            auto border = current_style( "border", xui::border() );
+            auto filled = current_style( "filled", xui::filled() );
+            auto align = current_style( "text-align", xui::alignment_flag::ALIGN_CENTER );
 
-                        if ( name.empty() == false )
+            // headers keep their full size, the clip around them trims the ones at the edges
+            auto header = [&]( xui::control_id id, const xui::rect & cell, const item_model::value_t & value )
+            {
+                xui::event_status status = xui::event_status::NORMAL;
+                draw_control_id( id, [&]()
+                {
+                    draw_viewport( cell, [&]()
+                    {
+                        status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+                        draw_style_status( status, [&]()
                         {
-                            draw_text( name, current_font_id(), rect, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
-                        }
+                            draw_rect( cell, current_style( "border", border ), current_style( "filled", filled ) );
+                            if ( auto str = std::get_if<std::string>( &value ) )
+                                draw_text( *str, current_font_id(), cell, current_style( "font-color", xui::color() ), align );
+                        } );
+                    } );
+                } );
+                return status;
+            };
 
-                        if ( menu )
+            // column headers, clicking one sorts by it and a second click flips the direction
+            auto columns = [&]( const xui::rect & clip, bool frozen_cols )
+            {
+                draw_clip( clip, [&]()
+                {
+                    for ( auto col : view.cols )
+                    {
+                        if ( ( col < frozen ) != frozen_cols )
+                            continue;
+
+                        auto cell = view.cell_rect( 0, col, _p->_factor );
+                        cell.y = view.rect.y;
+                        cell.h = view.header_h;
+
+                        auto value = model->col_header_data_exist( col ) ? model->col_header_data( col, xui::tableview_model::NAME ) : item_model::value_t();
+                        if ( header( view.id.child( "header" ).child( col ), cell, value ) == xui::event_status::ACTIVE )
                         {
-                            draw_path( current_style( "stroke", xui::stroke() ), {} )
-                                .moveto( { rect.x + rect.w - rect.h * 0.3f, rect.y + rect.h * 0.6f } )
-                                .lineto( { rect.x + rect.w - rect.h * 0.1f, rect.y + rect.h * 0.5f } )
-                                .lineto( { rect.x + rect.w - rect.h * 0.3f, rect.y + rect.h * 0.4f } )
-                                .closepath();
+                            model->sort( col, model->sort_col() == col ? !model->sort_ascending() : true );
+                            if ( view.batch )
+                                _p->fetch_cells( view );
                         }
-                    } );
+                    }
+                } );
+            };
+            if ( frozen > 0 )
+                columns( { view.rect.x + view.header_w, view.rect.y, view.frozen_w, view.header_h }, true );
+            columns( { view.body.x, view.rect.y, view.body.w, view.header_h }, false );
 
-                    if ( menu == false && status == xui::event_status::ACTIVE )
+            // row headers follow the vertical scroll only
+            if ( view.header_w > 0 )
+            {
+                draw_clip( { view.rect.x, view.body.y, view.header_w, view.body.h }, [&]()
+                {
+                    for ( int i = view.row; i < view.row_end; i++ )
                     {
-                        select_id = id;
+                        auto row = model->source_row( i );
+                        auto cell = view.cell_rect( i, 0, _p->_factor );
+                        cell.x = view.rect.x;
+                        cell.w = view.header_w;
+
+                        auto value = model->row_header_data_exist( row ) ? model->row_header_data( row, xui::tableview_model::NAME ) : item_model::value_t( std::to_string( row + 1 ) );
+                        header( view.id.child( "row-header" ).child( row ), cell, value );
                     }
                 } );
-            } );
+
+                header( view.id.child( "corner" ), { view.rect.x, view.rect.y, view.header_w, view.header_h }, {} );
+            }
         } );
+    } );
+}
 
-        if ( menu && select )
-        {
-            int count = 0;
-            float maxw = 0;
-            while ( model->item_exist( count, 0, id ) )
-            {
-                auto cid = model->index( count, 0, id );
+bool xui::context::tableview_item( int & row, int & col )
+{
+    auto & view = _p->_tableviews.back();
+    auto model = view.model;
 
-                float w = _p->_impl->font_size( current_font_id(), model->item_data( cid, xui::menu_model::NAME ).value<std::string>() ).w;
-                if ( model->item_data( cid, xui::menu_model::ICON ).value<xui::texture_id>() != xui::invalid_texture_id ) w += XUI_SCALE( 30 );
-                if ( model->item_data( cid, xui::menu_model::IS_MENU ).value<bool>() ) w += XUI_SCALE( 30 );
+    if ( view.pushed )
+    {
+        pop_viewport();
+        pop_clip();
+        pop_control_id();
+        view.pushed = false;
+    }
 
-                maxw = std::max( maxw, w );
+    int count = int( view.row_end - view.row ) * (int)view.cols.size();
+    if ( view.cell >= count || view.row >= model->view_count() )
+        return false;
 
-                count++;
-            }
+    // row-major over the visible window, view.row stays the first visible row
+    auto cell = view.cell++;
+    auto view_row = view.row + cell / (int)view.cols.size();
+    col = view.cols[cell % view.cols.size()];
+    row = model->source_row( view_row );
 
-            if ( count > 0 )
-            {
-                auto rect = current_viewport();
+    auto rect = view.cell_rect( view_row, col, _p->_factor );
+    auto id = model->index( row, col, {} );
+    auto row_id = model->index( row, 0, {} );
 
-                xui::rect list_rect = { rect.x + rect.w, rect.y, maxw, count * XUI_SCALE( 30.0f ) };
+    push_control_id( view.id.child( id.hash() ) );
+    _p->_clips.push_back( view.clips[col < model->frozen_cols() ? 0 : 1] );
+    push_viewport( rect );
+    view.pushed = true;
 
-                draw_rect( list_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    // selection is per row, a click on any cell selects the whole row
+    auto status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+    if ( status == xui::event_status::ACTIVE && view.state->selected != row_id )
+    {
+        if ( !view.state->selected.empty() )
+            model->item_data( view.state->selected, xui::tableview_model::IS_SELECTED, false );
 
-                for ( int row = 0; row < count; row++ )
-                {
-                    xui::rect sub_item_rect = { list_rect.x, list_rect.y + row * XUI_SCALE( 30 ), list_rect.w, XUI_SCALE( 30 ) };
-                    draw_viewport( sub_item_rect, [&]()
-                    {
-                        menu_item( row, 0, id, model, select_id );
-                    } );
-                }
-            }
-        }
-    } );
+        model->item_data( row_id, xui::tableview_model::IS_SELECTED, true );
+        view.state->selected = row_id;
+    }
 
-    return !select_id.empty();
+    if ( view.state->selected == row_id )
+        status = xui::event_status::ACTIVE;
+    else if ( status != xui::event_status::HOVER )
+        status = xui::event_status::NORMAL;
+
+    draw_rect( rect, view.borders[status], view.filleds[status] );
+
+    if ( model->is_item_custom() )
+    {
+        model->draw_item( this, rect );
+    }
+    else
+    {
+        if ( auto str = std::get_if<std::string_view>( &view.batch->at( cell, 0 ) ) )
+            draw_text( *str, current_font_id(), rect, view.colors[status], view.align );
+    }
+
+    return true;
 }
 
-bool xui::context::menubar( xui::item_model * model, xui::control_id & select_id )
+void xui::context::end_tableview()
 {
-    draw_zlevel( popup_z_level, [&]()
+    if ( _p->_tableviews.back().pushed )
     {
-        draw_style_type( "menubar", [&]()
-        {
-            draw_control_id( model->control_id, [&]()
-            {
-                auto rect = current_viewport();
-                xui::rect menubar_rect = { rect.x, rect.y - 1, rect.w, XUI_SCALE( 30 ) };
+        pop_viewport();
+        pop_clip();
+        pop_control_id();
+    }
 
-                draw_viewport( menubar_rect, [&]()
-                {
-                    draw_rect( menubar_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    if ( _p->_tableviews.back().batch )
+        _p->_batch_depth--;
 
-                    int row = 0;
-                    while ( model->item_exist( row, 0, {} ) )
-                    {
-                        auto id = model->index( row, 0, {} );
-                        auto icon = model->item_data( id, menubar_model::ICON ).value<xui::texture_id>();
-                        auto name = model->item_data( id, menubar_model::NAME ).value<std::string>();
-                        auto select = model->item_data( id, menubar_model::IS_SELECTED ).value<bool>();
-                        auto menu_model = model->item_data( id, menubar_model::MENUMODEL ).value<xui::item_model *>();
+    _p->_tableviews.pop_back();
+}
 
-                        auto name_size = _p->_impl->font_size( current_font_id(), name );
-                        xui::rect item_rect = { menubar_rect.x, menubar_rect.y, 0, 30 };
+bool xui::context::begin_itemview( xui::control_id ctl_id, int count )
+{
+    auto & view = _p->_itemviews.back();
+    auto & state = _p->_itemview_states[ctl_id.hash()];
 
-                        if ( icon != xui::invalid_texture_id )
-                            item_rect.w += item_rect.h;
+    _p->use( state.used );
+    view.id = ctl_id;
+    view.state = &state;
 
-                        item_rect.w += name_size.w;
+    auto rect = current_viewport();
+    float item_h = current_style( "item-height", 24.0f );
 
-                        draw_control_id( id, [&]()
-                        {
-                            draw_viewport( item_rect, [&]()
-                            {
-                                auto aid = get_act_control_id();
-                                auto hid = get_hot_control_id();
-                                xui::event_status status = xui::event_status::NORMAL;
+    draw_rect( rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
 
-                                if ( select && ( aid == id || hid == id || model->is_child( hid, id ) ) )
-                                    status = xui::event_status::ACTIVE;
-                                else
-                                    status = current_event_status( true );
+    // scroll offsets are unscaled model units in double, float runs out of precision around a million rows
+    double total = view.uniform > 0 ? count * (double)view.uniform : view.list->total_height();
+    double visible = rect.h / _p->_factor;
+    double range = std::max( 0.0, total - visible );
+    float step = ( view.uniform > 0 ? view.uniform : item_h ) * 3;
 
-                                model->item_data( id, menubar_model::IS_SELECTED, ( select = ( status == xui::event_status::ACTIVE ) ) );
+    const auto & input = _p->input( current_window_id() );
+    if ( input.wheel.y != 0 && rect.contains( input.cursor_pos ) )
+        state.offset -= input.wheel.y * step;
 
-                                draw_style_status( status, [&]()
-                                {
-                                    draw_rect( item_rect, current_style( "border", xui::border() ), current_style( "filled", xui::filled() ) );
+    view.rect = rect;
+    if ( range > 0 )
+    {
+        view.rect.w -= XUI_SCALE( 15 );
+        draw_viewport( { rect.x + view.rect.w, rect.y, XUI_SCALE( 15 ), rect.h }, [&]()
+        {
+            // only a scrollbar interaction moves the offset, by its delta so the double keeps its precision
+            float before = (float)state.offset, value = before;
+            scrollbar( ctl_id.child( "scrollbar" ), value, step, 0, (float)range, xui::direction::TOP_BOTTOM );
+            if ( value != before )
+                state.offset += value - before;
+        } );
+    }
+    state.offset = std::clamp( state.offset, 0.0, range );
 
-                                    float x = item_rect.x;
+    // rows keep their full height, the clip trims the ones at the edges
+    push_clip( view.rect );
+    view.clipped = true;
 
-                                    if ( icon != xui::invalid_texture_id )
-                                    {
-                                        draw_image( icon, { x, item_rect.y, item_rect.h, item_rect.h } );
-                                        x += item_rect.h;
-                                    }
+    auto clip = current_clip();
+    double top = state.offset + ( clip.y - view.rect.y ) / _p->_factor;
+    if ( count > 0 )
+    {
+        view.row = view.row_at( top, count );
+        view.end = std::min( view.row_at( top + clip.h / _p->_factor, count ) + 1, count );
+    }
 
-                                    draw_text( name, current_font_id(), { x, item_rect.y, name_size.w, item_rect.h }, current_style( "font-color", xui::color() ), current_style( "text-align", xui::alignment_flag::ALIGN_CENTER ) );
-                                } );
-                            } );
-                        } );
+    // item styles are resolved once per view instead of once per row
+    draw_style_element( "item", [&]()
+    {
+        view.align = current_style( "text-align", xui::alignment_flag::ALIGN_CENTER );
+        for ( auto status : { xui::event_status::NORMAL, xui::event_status::HOVER, xui::event_status::ACTIVE } )
+        {
+            draw_style_status( status, [&]()
+            {
+                view.borders[status] = current_style( "border", xui::border() );
+                view.filleds[status] = current_style( "filled", xui::filled() );
+                view.colors[status] = current_style( "font-color", xui::color() );
+            } );
+        }
+    } );
 
-                        if ( select )
-                            draw_viewport( { item_rect.x, item_rect.y + item_rect.h, rect.w - ( item_rect.x - rect.x ), rect.h }, [&]()
-                        {
-                            menu( menu_model, select_id );
-                        } );
+    return view.row < view.end;
+}
 
-                        menubar_rect = menubar_rect.margins_added( item_rect.w, 0, 0, 0 );
+bool xui::context::next_itemview_row( int & row, int count )
+{
+    auto & view = _p->_itemviews.back();
 
-                        row++;
-                    }
-                } );
+    if ( view.pushed )
+    {
+        pop_viewport();
+        pop_control_id();
+        view.pushed = false;
+    }
 
-                push_viewport( rect.margins_added( 0, 0, XUI_SCALE( 30 ), 0 ) );
-            } );
-        } );
-    } );
+    if ( view.row >= std::min( view.end, count ) )
+        return false;
 
-    if ( !select_id.empty() )
+    row = view.row++;
+
+    return true;
+}
+
+xui::event_status xui::context::itemview_item( int row, xui::control_id id, xui::item_model * model, int selected_role )
+{
+    auto & view = _p->_itemviews.back();
+
+    float top = float( view.offset( row ) - view.state->offset ), bottom = float( view.offset( row + 1 ) - view.state->offset );
+    xui::rect rect = { view.rect.x, view.rect.y + top * _p->_factor, view.rect.w, ( bottom - top ) * _p->_factor };
+
+    push_control_id( view.id.child( id.hash() ) );
+    push_viewport( rect );
+    view.pushed = true;
+
+    auto status = current_event_status( false, xui::event::KEY_MOUSE_LEFT_CLICK );
+    if ( status == xui::event_status::ACTIVE && view.state->selected != id )
     {
-        for ( int row = 0; model->item_exist( row, 0, {} ); ++row )
-        {
-            model->item_data( model->index( row, 0, {} ), menubar_model::IS_SELECTED, false );
-        }
+        if ( !view.state->selected.empty() )
+            model->item_data( view.state->selected, selected_role, false );
 
-        if ( model->is_child( get_hot_control_id(), {} ) )
-        {
-            set_hot_control_id( {} );
-        }
+        model->item_data( id, selected_role, true );
+        view.state->selected = id;
     }
 
-    return !select_id.empty();
+    if ( view.state->selected == id )
+        status = xui::event_status::ACTIVE;
+    else if ( status != xui::event_status::HOVER )
+        status = xui::event_status::NORMAL;
+
+    draw_rect( rect, view.borders[status], view.filleds[status] );
+
+    return status;
 }
 
-xui::drawcmd::text_element & xui::context::draw_text( std::string_view text, xui::font_id id, const xui::rect & rect, const xui::color & font_color, xui::alignment_flag text_align )
+void xui::context::end_itemview()
 {
-    xui::drawcmd::text_element element;
+    if ( _p->_itemviews.back().pushed )
+    {
+        pop_viewport();
+        pop_control_id();
+    }
 
-    element.font = id;
-    element.text = text;
-    element.rect = rect;
-    element.color = font_color;
-    element.align = text_align;
+    if ( _p->_itemviews.back().clipped )
+        pop_clip();
 
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++, current_window_id(), element } );
+    if ( _p->_itemviews.back().batch )
+        _p->_batch_depth--;
+
+    _p->_itemviews.pop_back();
+}
+
+xui::drawcmd::text_element & xui::context::draw_text( std::string_view text, xui::font_id id, const xui::rect & rect, const xui::color & font_color, xui::alignment_flag text_align )
+{
+    xui::drawcmd::text_element element{ rect, font_color, { _p->copy<char>( text ), text.size() }, id, text_align };
 
-    return std::get<xui::drawcmd::text_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::TEXT, _p->_frame->list.texts, std::move( element ) );
 }
 
 xui::drawcmd::line_element & xui::context::draw_line( const xui::vec2 & p1, const xui::vec2 & p2, const xui::stroke & stroke )
@@ -2812,11 +5906,11 @@ xui::drawcmd::line_element & xui::context::draw_line( const xui::vec2 & p1, cons
 
     element.p1 = p1;
     element.p2 = p2;
-    element.stroke = stroke;
 
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
+    xui::border border;
+    static_cast<xui::stroke &>( border ) = stroke;
 
-    return std::get<xui::drawcmd::line_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::LINE, _p->_frame->list.lines, std::move( element ), _p->stroke_paint( border ) );
 }
 
 xui::drawcmd::rect_element & xui::context::draw_rect( const xui::rect & rect, const xui::border & border, const xui::filled filled )
@@ -2824,24 +5918,18 @@ xui::drawcmd::rect_element & xui::context::draw_rect( const xui::rect & rect, co
     xui::drawcmd::rect_element element;
 
     element.rect = rect;
-    element.border = border;
-    element.filled = filled;
-
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
 
-    return std::get<xui::drawcmd::rect_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::RECT, _p->_frame->list.rects, std::move( element ), _p->stroke_paint( border ), _p->fill_paint( filled ) );
 }
 
 xui::drawcmd::path_element & xui::context::draw_path( const xui::stroke & stroke, const xui::filled filled )
 {
-    xui::drawcmd::path_element element;
+    xui::drawcmd::path_element element{ std::pmr::vector<xui::drawcmd::path_element::command>( &_p->_frame->arena ), std::pmr::vector<xui::vec2>( &_p->_frame->arena ) };
 
-    element.stroke = stroke;
-    element.filled = filled;
+    xui::border border;
+    static_cast<xui::stroke &>( border ) = stroke;
 
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
-
-    return std::get<xui::drawcmd::path_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::PATH, _p->_frame->list.paths, std::move( element ), _p->stroke_paint( border ), _p->fill_paint( filled ) );
 }
 
 xui::drawcmd::image_element & xui::context::draw_image( xui::texture_id id, const xui::rect & rect )
@@ -2851,9 +5939,7 @@ xui::drawcmd::image_element & xui::context::draw_image( xui::texture_id id, cons
     element.id = id;
     element.rect = rect;
 
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
-
-    return std::get<xui::drawcmd::image_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::IMAGE, _p->_frame->list.images, std::move( element ) );
 }
 
 xui::drawcmd::circle_element & xui::context::draw_circle( const xui::vec2 & center, float radius, const xui::border & border, const xui::filled filled )
@@ -2862,12 +5948,8 @@ xui::drawcmd::circle_element & xui::context::draw_circle( const xui::vec2 & cent
 
     element.center = center;
     element.radius = radius;
-    element.border = border;
-    element.filled = filled;
 
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
-
-    return std::get<xui::drawcmd::circle_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::CIRCLE, _p->_frame->list.circles, std::move( element ), _p->stroke_paint( border ), _p->fill_paint( filled ) );
 }
 
 xui::drawcmd::ellipse_element & xui::context::draw_ellipse( const xui::vec2 & center, const xui::vec2 & radius, const xui::border & border, const xui::filled filled )
@@ -2876,23 +5958,13 @@ xui::drawcmd::ellipse_element & xui::context::draw_ellipse( const xui::vec2 & ce
 
     element.center = center;
     element.radius = radius;
-    element.border = border;
-    element.filled = filled;
-
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++,current_window_id(), element } );
 
-    return std::get<xui::drawcmd::ellipse_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::ELLIPSE, _p->_frame->list.ellipses, std::move( element ), _p->stroke_paint( border ), _p->fill_paint( filled ) );
 }
 
 xui::drawcmd::polygon_element & xui::context::draw_polygon( std::span<xui::vec2> points, const xui::border & border, const xui::filled filled )
 {
-    xui::drawcmd::polygon_element element;
-
-    element.points.assign( points.begin(), points.end() );
-    element.border = border;
-    element.filled = filled;
-
-    _p->_commands.push_back( { current_zlevel() + _p->_zvalue++, current_window_id(), element } );
+    xui::drawcmd::polygon_element element{ { _p->copy<xui::vec2>( points ), points.size() } };
 
-    return std::get<xui::drawcmd::polygon_element>( _p->_commands.back().element );
+    return _p->push( current_window_id(), current_zlevel(), xui::drawcmd::POLYGON, _p->_frame->list.polygons, std::move( element ), _p->stroke_paint( border ), _p->fill_paint( filled ) );
 }
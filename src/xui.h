@@ -1,7 +1,10 @@
 ﻿#pragma once
 
 #include <map>
+#include <deque>
 #include <span>
+#include <bitset>
+#include <algorithm>
 #include <format>
 #include <string>
 #include <variant>
@@ -9,6 +12,8 @@
 #include <optional>
 #include <functional>
 #include <system_error>
+#include <unordered_map>
+#include <unordered_set>
 #include <memory_resource>
 
 
@@ -39,12 +44,14 @@ namespace xui
 	class stroke;
 	class border;
 	class filled;
+	class control_id;
 	class hatch_color;
 	class texture_brush;
 	class linear_gradient;
 
 	class style;
 	class drawcmd;
+	class drawlist;
 	class context;
 	class implement;
 
@@ -58,9 +65,12 @@ namespace xui
 
 	inline constexpr std::size_t hash( const char * str, std::size_t size = std::numeric_limits<size_t>::max(), std::size_t value = 14695981039346656037ULL )
 	{
-		while ( *str++ != '\0' && size-- != 0 )
+		if ( size == std::numeric_limits<size_t>::max() )
+			size = std::char_traits<char>::length( str );
+
+		for ( std::size_t i = 0; i < size; ++i )
 		{
-			value ^= static_cast<std::size_t>( *str );
+			value ^= static_cast<std::size_t>( str[i] );
 			value *= 1099511628211ULL;
 		}
 
@@ -288,10 +298,49 @@ namespace xui
 	using font_id = XUI_FONT_ID;
 	using window_id = XUI_WINDOW_ID;
 	using texture_id = XUI_TEXTURE_ID;
-	using control_id = std::string_view;
+	using paint_id = std::uint32_t;
 	static constexpr const font_id invalid_font_id = XUI_INVALID_FONT_ID;
 	static constexpr const window_id invalid_window_id = XUI_INVALID_WINDOW_ID;
 	static constexpr const texture_id invalid_texture_id = XUI_INVALID_TEXTURE_ID;
+
+	class control_id
+	{
+	public:
+		constexpr control_id() = default;
+		constexpr explicit control_id( std::size_t hash )
+			: _hash( hash )
+		{
+		}
+		control_id( const char * name )
+			: control_id( std::string_view( name ) )
+		{
+		}
+		control_id( const std::string & name )
+			: control_id( std::string_view( name ) )
+		{
+		}
+		control_id( std::string_view name );
+
+	public:
+		constexpr bool empty() const
+		{
+			return _hash == 0;
+		}
+		constexpr std::size_t hash() const
+		{
+			return _hash;
+		}
+		xui::control_id child( std::size_t index ) const;
+		xui::control_id child( std::string_view name ) const;
+		std::string name() const;
+
+	public:
+		constexpr bool operator==( const control_id & ) const = default;
+		constexpr auto operator<=>( const control_id & ) const = default;
+
+	private:
+		std::size_t _hash = 0;
+	};
 	static constexpr const control_id invalid_control_id = {};
 	
 	class url : public std::string
@@ -305,18 +354,6 @@ namespace xui
 
 	private:
 		template<typename T> struct constexpr_flags;
-		template<> struct constexpr_flags<char>
-		{
-			static constexpr const char * scheme_flag = "://";
-			static constexpr const char * username_flag = "@";
-			static constexpr const char * password_flag = ":";
-			static constexpr const char * host_flag = "/";
-			static constexpr const char * port_flag = ":";
-			static constexpr const char * path_flag = "?";
-			static constexpr const char * fragment_flag = "#";
-			static constexpr const char query_flag = '=';
-			static constexpr const char query_pair_flag = '&';
-		};
 
 	public:
 		url() = default;
@@ -367,6 +404,18 @@ namespace xui
 		string_view_type _query;
 		string_view_type _fragment;
 	};
+	template<> struct url::constexpr_flags<char>
+	{
+		static constexpr const char * scheme_flag = "://";
+		static constexpr const char * username_flag = "@";
+		static constexpr const char * password_flag = ":";
+		static constexpr const char * host_flag = "/";
+		static constexpr const char * port_flag = ":";
+		static constexpr const char * path_flag = "?";
+		static constexpr const char * fragment_flag = "#";
+		static constexpr const char query_flag = '=';
+		static constexpr const char query_pair_flag = '&';
+	};
 
 	class vec2
 	{
@@ -597,26 +646,42 @@ namespace xui
 	public:
 		bool parse( std::string_view str );
 		xui::style::variant find( std::string_view name ) const;
+		xui::style::variant find( std::size_t id, std::string_view type, std::span<const std::string_view> elements, std::string_view status, std::string_view attr ) const;
+		template<typename F> xui::style::variant find( std::size_t key, F && resolve ) const
+		{
+			auto it = _cache.find( key );
+			if ( it == _cache.end() )
+				it = _cache.insert( { key, resolve() } ).first;
+
+			return it->second;
+		}
 		template<typename T, typename Container> void get_values( Container & _c ) const
 		{
-			for ( const auto & it : _selectors )
+			for ( const auto & it : _values )
 			{
-				for ( const auto & addr : it.second.attrs )
+				std::visit( overload(
+					[&]( const T & val )
 				{
-					std::visit( overload(
-						[&]( const T & val )
-					{
-						_c.push_back( val );
-					},
-						[]( const auto & )
-					{}
-					), addr.second );
-				}
+					_c.push_back( val );
+				},
+					[]( const auto & )
+				{}
+				), it );
 			}
 		}
 
 	private:
-		std::optional<xui::style::variant> find( std::string_view type, std::string_view attr ) const;
+		struct slot
+		{
+			std::uint64_t key = 0;
+			std::uint32_t value = std::numeric_limits<std::uint32_t>::max();
+		};
+
+	private:
+		void compile( const std::pmr::map<std::string, selector> & selectors );
+		std::uint32_t atom( std::size_t name ) const;
+		std::uint32_t intern( std::size_t name );
+		const xui::style::variant * lookup( std::size_t selector, std::uint32_t attr ) const;
 
 	private:
 		static xui::style::selector parse_selector( std::string_view::iterator & beg, std::string_view::iterator end );
@@ -650,72 +715,111 @@ namespace xui
 		}
 
 	private:
-		std::pmr::map<std::string, selector> _selectors;
+		std::uint32_t _atom_count = 0;
+		std::pmr::vector<slot> _atoms;
+		std::pmr::vector<slot> _table;
+		std::pmr::vector<variant> _values;
+		mutable std::pmr::unordered_map<std::size_t, variant> _cache;
 	};
 
 	class drawcmd
 	{
 	public:
+		enum element_kind : std::uint8_t
+		{
+			NONE,
+			TEXT,
+			LINE,
+			RECT,
+			PATH,
+			IMAGE,
+			CIRCLE,
+			ELLIPSE,
+			POLYGON,
+		};
+
 		struct text_element
 		{
 			xui::rect rect;
 			xui::color color;
-			std::string text;
+			std::string_view text;
 			xui::font_id font;
 			xui::alignment_flag align = xui::alignment_flag::ALIGN_CENTER;
 		};
 		struct line_element
 		{
 			xui::vec2 p1, p2;
-			xui::stroke stroke;
 		};
 		struct rect_element
 		{
 			xui::rect rect;
-			xui::border border;
-			xui::filled filled;
 		};
 		struct path_element
 		{
+			enum command : std::uint8_t
+			{
+				MOVETO,
+				LINETO,
+				CURVETO,
+				SMOOTH_CURVETO,
+				QUADRATIC_CURVETO,
+				SMOOTH_QUADRATIC_CURVETO,
+				CLOSEPATH,
+			};
+
+			static constexpr std::size_t point_count( command cmd )
+			{
+				constexpr std::size_t counts[] = { 1, 1, 3, 2, 2, 1, 0 };
+				return counts[cmd];
+			}
+
 			inline path_element & moveto( const xui::vec2 & p )
 			{
-				data.append( std::format( "M{} {} ", p.x, p.y ) );
+				commands.push_back( MOVETO );
+				points.push_back( p );
 				return *this;
 			}
 			inline path_element & lineto( const xui::vec2 & p )
 			{
-				data.append( std::format( "L{} {} ", p.x, p.y ) );
+				commands.push_back( LINETO );
+				points.push_back( p );
 				return *this;
 			}
 			inline path_element & curveto( const xui::vec2 & c1, const xui::vec2 & c2, const xui::vec2 & e )
 			{
-				data.append( std::format( "C{} {} {} {} {} {} ", c1.x, c1.y, c2.x, c2.y, e.x, e.y ) );
+				commands.push_back( CURVETO );
+				points.insert( points.end(), { c1, c2, e } );
 				return *this;
 			}
 			inline path_element & smooth_curveto( const xui::vec2 & c, const xui::vec2 & e )
 			{
-				data.append( std::format( "S{} {} {} {} ", c.x, c.y, e.x, e.y ) );
+				commands.push_back( SMOOTH_CURVETO );
+				points.insert( points.end(), { c, e } );
 				return *this;
 			}
 			inline path_element & quadratic_belzier_curve( const xui::vec2 & c, const xui::vec2 & e )
 			{
-				data.append( std::format( "Q{} {} {} {} ", c.x, c.y, e.x, e.y ) );
+				commands.push_back( QUADRATIC_CURVETO );
+				points.insert( points.end(), { c, e } );
 				return *this;
 			}
 			inline path_element & smooth_quadratic_belzier_curveto( const xui::vec2 & e )
 			{
-				data.append( std::format( "T{} {} ", e.x, e.y ) );
+				commands.push_back( SMOOTH_QUADRATIC_CURVETO );
+				points.push_back( e );
 				return *this;
 			}
 			inline path_element & closepath()
 			{
-				data.append( "Z " );
+				commands.push_back( CLOSEPATH );
 				return *this;
 			}
 
-			std::string data;
-			xui::stroke stroke;
-			xui::filled filled;
+			path_element & from_svg( std::string_view data );
+			std::string to_svg() const;
+
+			std::pmr::vector<command> commands;
+			std::pmr::vector<xui::vec2> points;
 		};
 		struct image_element
 		{
@@ -726,27 +830,141 @@ namespace xui
 		{
 			float radius = 1;
 			xui::vec2 center;
-			xui::border border;
-			xui::filled filled;
 		};
 		struct ellipse_element
 		{
 			xui::vec2 center;
 			xui::vec2 radius;
-			xui::border border;
-			xui::filled filled;
 		};
 		struct polygon_element
 		{
-			xui::border border;
-			xui::filled filled;
-			std::pmr::vector<xui::vec2> points;
+			std::span<const xui::vec2> points;
 		};
-		
+
+	public:
+		xui::rect bounds() const
+		{
+			return { (float)left, (float)top, (float)( right - left ), (float)( bottom - top ) };
+		}
+
 	public:
-		size_t z = 0;
 		window_id id = xui::invalid_window_id;
-		std::variant<std::monostate, text_element, line_element, rect_element, path_element, image_element, circle_element, ellipse_element, polygon_element> element;
+		std::int16_t left = 0, top = 0, right = 0, bottom = 0;
+		std::uint32_t z : 24 = 0;
+		std::uint32_t kind : 8 = NONE;
+		std::uint32_t index = 0;
+		xui::paint_id stroke = 0;
+		xui::paint_id fill = 0;
+		std::uint32_t clip = 0;
+	};
+
+	class drawlist
+	{
+	public:
+		drawlist( std::pmr::memory_resource * res = std::pmr::get_default_resource() )
+			: commands( res ), texts( res ), lines( res ), rects( res ), paths( res ), images( res ), circles( res ), ellipses( res ), polygons( res ), clips( res )
+		{
+		}
+
+		drawlist( drawlist && ) = default;
+		drawlist & operator=( drawlist && ) = default;
+
+	private:
+		drawlist( const drawlist & ) = delete;
+		drawlist & operator=( const drawlist & ) = delete;
+
+	public:
+		std::size_t size() const
+		{
+			return commands.size();
+		}
+		bool empty() const
+		{
+			return commands.empty();
+		}
+		auto begin() const
+		{
+			return commands.begin();
+		}
+		auto end() const
+		{
+			return commands.end();
+		}
+		const xui::drawcmd & operator[]( std::size_t idx ) const
+		{
+			return commands[idx];
+		}
+
+	public:
+		const xui::border & stroke( const xui::drawcmd & cmd ) const
+		{
+			return strokes[cmd.stroke];
+		}
+		const xui::filled & fill( const xui::drawcmd & cmd ) const
+		{
+			return fills[cmd.fill];
+		}
+		const xui::rect & clip( const xui::drawcmd & cmd ) const
+		{
+			return clips[cmd.clip];
+		}
+		template<typename F> void visit( const xui::drawcmd & cmd, F && func ) const
+		{
+			switch ( cmd.kind )
+			{
+			case xui::drawcmd::TEXT: func( texts[cmd.index] ); break;
+			case xui::drawcmd::LINE: func( lines[cmd.index] ); break;
+			case xui::drawcmd::RECT: func( rects[cmd.index] ); break;
+			case xui::drawcmd::PATH: func( paths[cmd.index] ); break;
+			case xui::drawcmd::IMAGE: func( images[cmd.index] ); break;
+			case xui::drawcmd::CIRCLE: func( circles[cmd.index] ); break;
+			case xui::drawcmd::ELLIPSE: func( ellipses[cmd.index] ); break;
+			case xui::drawcmd::POLYGON: func( polygons[cmd.index] ); break;
+			default: break;
+			}
+		}
+
+	public:
+		xui::rect measure( const xui::drawcmd & cmd ) const;
+
+	public:
+		// headers are sorted by window and z, payloads stay in push order and are reached through drawcmd::index
+		std::pmr::vector<xui::drawcmd> commands;
+		std::pmr::vector<xui::drawcmd::text_element> texts;
+		std::pmr::vector<xui::drawcmd::line_element> lines;
+		std::pmr::vector<xui::drawcmd::rect_element> rects;
+		std::pmr::vector<xui::drawcmd::path_element> paths;
+		std::pmr::vector<xui::drawcmd::image_element> images;
+		std::pmr::vector<xui::drawcmd::circle_element> circles;
+		std::pmr::vector<xui::drawcmd::ellipse_element> ellipses;
+		std::pmr::vector<xui::drawcmd::polygon_element> polygons;
+		// clip 0 is unbounded, the others are already intersected with their parents
+		std::pmr::vector<xui::rect> clips;
+		// the context paint table indexed by xui::paint_id, shared by every frame
+		std::span<const xui::border> strokes;
+		std::span<const xui::filled> fills;
+	};
+
+	struct input_state
+	{
+		input_state( std::pmr::memory_resource * res = std::pmr::get_default_resource() )
+			: unicodes( res ), touchs( res )
+		{
+		}
+
+		bool test( xui::event key ) const
+		{
+			return events.test( key );
+		}
+
+		xui::rect rect;
+		xui::vec2 cursor_pos;
+		xui::vec2 cursor_dt;
+		xui::vec2 wheel;
+		xui::window_status status = {};
+		std::bitset<xui::event::EVENT_MAX_COUNT> events;
+		std::pmr::string unicodes;
+		std::pmr::vector<xui::vec2> touchs;
 	};
 
 	class context
@@ -778,11 +996,37 @@ namespace xui
 
 	public:
 		void set_scale( float factor );
-		
+
+	public:
+		void reserve_frame_memory( std::size_t size );
+		std::size_t frame_memory_used() const;
+		std::size_t frame_memory_capacity() const;
+		std::size_t frame_memory_high_water() const;
+
+	public:
+		bool changed() const;
+		std::span<const xui::rect> damaged_rects( xui::window_id id ) const;
+
+	public:
+		// off by default, drops commands hidden under opaque unclipped solid rects before they reach the backend
+		void set_occlusion_culling( bool enable );
+		// bounding box area of the commands sent by the last end(), divide by the window area for the overdraw
+		std::size_t drawn_pixels() const;
+		std::size_t occluded_pixels() const;
+		std::size_t occluded_commands() const;
+
+	public:
+		xui::size font_size( xui::font_id id, std::string_view text );
+		void remove_font( xui::font_id id );
+		void set_font_cache_capacity( std::size_t count );
+		std::size_t font_cache_hits() const;
+		std::size_t font_cache_misses() const;
+
 	public:
 		void push_style( xui::style * style );
 		void pop_style();
 		std::string current_style_name() const;
+		std::size_t current_style_hash( std::string_view attr ) const;
 		xui::style::variant current_style( std::string_view attr ) const;
 		template<typename T> T current_style( std::string_view attr, const T & def ) const
 		{
@@ -840,6 +1084,20 @@ namespace xui
 		void pop_viewport();
 		xui::rect current_viewport() const;
 
+		void push_clip( const xui::rect & rect );
+		void pop_clip();
+		xui::rect current_clip() const;
+		bool is_visible( const xui::rect & rect ) const;
+
+		// false replays the commands the region drew last frame, the version must change whenever anything but input changes its output
+		bool begin_cached_region( xui::control_id id, std::size_t version );
+		void end_cached_region();
+
+		// false means the layer texture is still valid and only its image is drawn, widgets inside see no input until it is invalidated
+		bool push_layer( xui::control_id id, const xui::rect & rect );
+		void pop_layer();
+		void invalidate_layer( xui::control_id id );
+
 	public:
 		template<typename F> void draw_zlevel( size_t val, F && f )
 		{
@@ -859,6 +1117,24 @@ namespace xui
 			f();
 			pop_viewport();
 		}
+		template<typename F> void draw_clip( const xui::rect & rect, F && f )
+		{
+			push_clip( rect );
+			f();
+			pop_clip();
+		}
+		template<typename F> void cached_region( xui::control_id id, std::size_t version, F && f )
+		{
+			if ( begin_cached_region( id, version ) )
+				f();
+			end_cached_region();
+		}
+		template<typename F> void draw_layer( xui::control_id id, const xui::rect & rect, F && f )
+		{
+			if ( push_layer( id, rect ) )
+				f();
+			pop_layer();
+		}
 
 	public:
 		void push_font_id( xui::font_id font );
@@ -909,10 +1185,11 @@ namespace xui
 		void set_act_control_id( xui::control_id id );
 		void set_hot_control_id( xui::control_id id );
 		xui::event_status current_event_status( bool hot = false, xui::event event = xui::event::KEY_MOUSE_LEFT );
+		const xui::input_state & current_input();
 
 	public:
 		void begin();
-		std::span<xui::drawcmd> end();
+		const xui::drawlist & end();
 
 	public:
 		bool begin_window( std::string_view title, xui::texture_id icon_id, int flags = xui::window_flag::WINDOW_NONE );
@@ -943,11 +1220,23 @@ namespace xui
 
 	public:
 		bool begin_horizontal_layout( std::span<int> stretch, xui::layout_direction dir = xui::layout_direction::LAYOUT_NORMAL );
+		bool begin_horizontal_layout( xui::control_id ctl_id, std::span<int> stretch, xui::layout_direction dir = xui::layout_direction::LAYOUT_NORMAL );
 		void end_horizontal_layout();
-		bool begin_vertical_layout();
+		bool begin_vertical_layout( std::span<int> stretch = {}, xui::layout_direction dir = xui::layout_direction::LAYOUT_NORMAL );
+		bool begin_vertical_layout( xui::control_id ctl_id, std::span<int> stretch, xui::layout_direction dir = xui::layout_direction::LAYOUT_NORMAL );
 		void end_vertical_layout();
-		bool begin_grid_layout();
+		bool begin_grid_layout( int columns = 0 );
+		bool begin_grid_layout( xui::control_id ctl_id, int columns );
 		void end_grid_layout();
+		xui::rect next_layout_item( const xui::size & hint = {} );
+
+	public:
+		template<typename F> void draw_layout_item( const xui::size & hint, F && func )
+		{
+			push_viewport( next_layout_item( hint ) );
+			func();
+			pop_viewport();
+		}
 
 	public:
 		bool begin_combobox();
@@ -961,19 +1250,22 @@ namespace xui
 		void end_tabview();
 
 	public:
-		bool begin_listview();
+		bool begin_listview( xui::listview_model * model );
+		bool begin_listview( xui::control_id ctl_id, xui::listview_model * model );
 		void end_listview();
-		bool listview_item();
+		bool listview_item( int & row );
 
 	public:
-		bool begin_treeview();
+		bool begin_treeview( xui::treeview_model * model );
+		bool begin_treeview( xui::control_id ctl_id, xui::treeview_model * model );
 		void end_treeview();
-		bool treeview_item();
+		bool treeview_item( int & row );
 
 	public:
-		bool begin_tableview();
+		bool begin_tableview( xui::tableview_model * model );
+		bool begin_tableview( xui::control_id ctl_id, xui::tableview_model * model );
 		void tableview_header();
-		void tableview_item();
+		bool tableview_item( int & row, int & col );
 		void end_tableview();
 
 	public:
@@ -989,6 +1281,12 @@ namespace xui
 	private:
 		bool menu_item( int row, int col, xui::control_id parent, xui::item_model * model, xui::control_id & select_id );
 
+	private:
+		bool begin_itemview( xui::control_id ctl_id, int count );
+		bool next_itemview_row( int & row, int count );
+		xui::event_status itemview_item( int row, xui::control_id id, xui::item_model * model, int selected_role );
+		void end_itemview();
+
 	private:
 		private_p * _p;
 	};
@@ -1037,13 +1335,28 @@ namespace xui
 		virtual std::span<xui::vec2> get_touchs( xui::window_id id ) const = 0;
 		virtual std::string get_clipboard_data( xui::window_id id, std::string_view mime ) const = 0;
 		virtual bool set_clipboard_data( xui::window_id id, std::string_view mime, std::string_view data ) = 0;
+
+	public:
+		virtual void create_paint( xui::paint_id id, const xui::border & stroke ) = 0;
+		virtual void create_paint( xui::paint_id id, const xui::filled & fill ) = 0;
+		virtual void remove_paint( xui::paint_id id ) = 0;
+
+	public:
+		// render targets are textures the backend draws a drawlist into, every command of that list has window id 0
+		virtual xui::texture_id create_render_target( int width, int height ) = 0;
+		virtual void update_render_target( xui::texture_id id, const xui::drawlist & list ) = 0;
+		virtual void remove_render_target( xui::texture_id id ) = 0;
+
+	public:
+		virtual void damage_window( xui::window_id id, std::span<const xui::rect> rects ) = 0;
 	};
 
 
 	class item_model
 	{
 	private:
-		using variant = std::variant<std::monostate, bool, int, float, std::string, xui::texture_id, xui::color, xui::filled, xui::item_model *, xui::alignment_flag>;
+		using variant = std::variant<std::monostate, bool, int, float, std::string, xui::texture_id, xui::control_id, xui::color, xui::filled, xui::item_model *, xui::alignment_flag>;
+		using view_variant = std::variant<std::monostate, bool, int, float, std::string_view, xui::texture_id, xui::control_id, xui::color, xui::filled, xui::item_model *, xui::alignment_flag>;
 
 	public:
 		struct value_t : public variant
@@ -1056,8 +1369,34 @@ namespace xui
 			}
 		};
 
+		struct value_view : public view_variant
+		{
+			using view_variant::view_variant;
+
+			template<typename T> T value( const T & def = {} ) const
+			{
+				if ( auto p = std::get_if<T>( this ) )
+					return *p;
+
+				return def;
+			}
+		};
+
+		// rows x roles written by fetch_rows, strings holds copies for models that cannot hand out views
+		struct item_batch
+		{
+			const value_view & at( int row, int role ) const
+			{
+				return values[row * stride + role];
+			}
+
+			int stride = 0;
+			std::vector<value_view> values;
+			std::deque<std::string> strings;
+		};
+
 	public:
-		item_model( std::string_view cid )
+		item_model( xui::control_id cid )
 			: control_id( cid )
 		{
 		}
@@ -1076,6 +1415,40 @@ namespace xui
 		virtual value_t item_data( xui::control_id id, int role ) = 0;
 		virtual void item_data( xui::control_id id, int role, const value_t & val ) = 0;
 
+	public:
+		// fills every role for rows [first, first + count) of parent in one call, views stay valid until the model changes
+		virtual void fetch_rows( xui::control_id parent, int first, int count, std::span<const int> roles, item_batch & batch )
+		{
+			batch.stride = (int)roles.size();
+			batch.values.resize( count * roles.size() );
+			batch.strings.clear();
+
+			for ( int i = 0; i < count; i++ )
+				fetch_item( index( first + i, 0, parent ), i, roles, batch );
+		}
+		// like fetch_rows for items that are not consecutive rows of one parent, batch row i holds ids[i]
+		virtual void fetch_items( std::span<const xui::control_id> ids, std::span<const int> roles, item_batch & batch )
+		{
+			batch.stride = (int)roles.size();
+			batch.values.resize( ids.size() * roles.size() );
+			batch.strings.clear();
+
+			for ( int i = 0; i < (int)ids.size(); i++ )
+				fetch_item( ids[i], i, roles, batch );
+		}
+
+	protected:
+		void fetch_item( xui::control_id id, int row, std::span<const int> roles, item_batch & batch )
+		{
+			for ( int j = 0; j < batch.stride; j++ )
+			{
+				auto val = item_data( id, roles[j] );
+				batch.values[row * batch.stride + j] = std::visit( xui::overload{
+					[&]( std::string & str ) -> value_view { return std::string_view( batch.strings.emplace_back( std::move( str ) ) ); },
+					[]( auto & val ) -> value_view { return val; } }, static_cast<variant &>( val ) );
+			}
+		}
+
 	public:
 		virtual bool row_header_data_exist( int row ) const { return false; }
 		virtual bool col_header_data_exist( int row ) const { return false; }
@@ -1090,7 +1463,21 @@ namespace xui
 		virtual void draw_item( xui::context * ctx, const xui::rect & rect ) const {}
 
 	public:
-		std::string control_id;
+		// changes whenever rows or their data change, selection state does not count
+		std::uint64_t revision() const
+		{
+			return _revision;
+		}
+		void bump_revision()
+		{
+			++_revision;
+		}
+
+	public:
+		xui::control_id control_id;
+
+	private:
+		std::uint64_t _revision = 0;
 	};
 
 	class menu_model : public item_model
@@ -1106,65 +1493,35 @@ namespace xui
 			IS_SELECTED,
 		};
 
+		// nodes are stored in pre-order, a handle is the node's index and [handle, exit) covers its subtree
 		struct item
 		{
-			~item()
-			{
-				for ( auto it : childrens )
-					delete it;
-			}
-
 			bool selected = false;
 			xui::texture_id icon = xui::invalid_texture_id;
 			std::string name = {};
 			std::string shortcuts = {};
-			std::vector<item *> childrens = {};
 
-			std::string id = {};
-			std::string parent = {};
+			int parent = -1;
+			int exit = 0;
 		};
 
 	public:
-		menu_model( std::string_view cid )
+		menu_model( xui::control_id cid )
 			: item_model( cid )
 		{
-			root.id = cid;
-			stack.push_back( &root );
-		}
-		~menu_model() override
-		{
-			for ( auto it : root.childrens )
-				delete it;
+			nodes.push_back( {} );
+			nodes[0].exit = 1;
+			stack.push_back( 0 );
 		}
 
 	public:
 		void beg_menu( std::string_view name, xui::texture_id icon = xui::invalid_texture_id, std::string_view shortcuts = "" )
 		{
-			auto it = new item;
-
-			it->id = std::format( "{}_{}", stack.back()->id, stack.back()->childrens.size() );
-			it->name = name;
-			it->icon = icon;
-			it->parent = stack.back()->id;
-			it->shortcuts = shortcuts;
-
-			stack.back()->childrens.push_back( it );
-
-			stack.push_back( it );
+			stack.push_back( append( name, icon, shortcuts ) );
 		}
 		xui::control_id add_item( std::string_view name, xui::texture_id icon = xui::invalid_texture_id, std::string_view shortcuts = "" )
 		{
-			auto it = new item;
-
-			it->id = std::format( "{}_{}", stack.back()->id, stack.back()->childrens.size() );
-			it->name = name;
-			it->icon = icon;
-			it->parent = stack.back()->id;
-			it->shortcuts = shortcuts;
-
-			stack.back()->childrens.push_back( it );
-
-			return it->id;
+			return id( append( name, icon, shortcuts ) );
 		}
 		void end_menu()
 		{
@@ -1172,60 +1529,51 @@ namespace xui
 		}
 
 	public:
-		bool is_child( xui::control_id id, xui::control_id parent ) const override
+		// ids are derived from the handle, so they cost nothing until asked for and map back without a lookup table
+		xui::control_id id( int handle ) const
 		{
-			if ( id.empty() || id == parent )
-				return false;
+			return handle <= 0 ? control_id : xui::control_id( control_id.hash() + handle );
+		}
+		int handle( xui::control_id id ) const
+		{
+			if ( id.empty() || id == control_id )
+				return 0;
 
-			if ( auto item = find( id ) )
-			{
-				if ( parent != xui::invalid_control_id )
-				{
-					auto p = item->parent;
-					while ( 1 )
-					{
-						if ( p == xui::invalid_control_id )
-							return false;
+			auto h = id.hash() - control_id.hash();
+			return h < nodes.size() ? (int)h : -1;
+		}
 
-						if ( p == parent )
-							return true;
+	public:
+		bool is_child( xui::control_id id, xui::control_id parent ) const override
+		{
+			auto h = handle( id );
+			if ( h <= 0 || id == parent )
+				return false;
 
-						if ( auto item = find( p ) )
-						{
-							p = item->parent;
-						}
-					}
-				}
-				else
-				{
-					return true;
-				}
-			}
+			if ( parent == xui::invalid_control_id )
+				return true;
 
-			return false;
+			auto p = handle( parent );
+			return p >= 0 && p < h && h < nodes[p].exit;
 		}
 		
 		xui::control_id parent( xui::control_id id ) const override
 		{
-			if ( auto it = find( id ) )
-				return it->parent;
+			auto h = handle( id );
+			if ( h > 0 )
+				return this->id( nodes[h].parent );
 
 			return {};
 		}
 		bool item_exist( int row, int col, xui::control_id parent ) const override
 		{
-			if ( auto it = find( parent ) )
-				return ( row < it->childrens.size() );
-
-			return false;
+			return row >= 0 && row < row_count( parent );
 		}
 		xui::control_id index( int row, int col, xui::control_id parent ) const override
 		{
-			if ( auto it = find( parent ) )
-			{
-				if ( row < it->childrens.size() )
-					return it->childrens[row]->id;
-			}
+			auto p = handle( parent );
+			if ( p >= 0 && row >= 0 && row < row_count( parent ) )
+				return id( children()[offsets[p] + row] );
 
 			return {};
 		}
@@ -1233,9 +1581,11 @@ namespace xui
 	public:
 		int row_count( xui::control_id parent ) const override
 		{
-			if ( auto it = find( parent ) )
+			auto p = handle( parent );
+			if ( p >= 0 )
 			{
-				return (int)it->childrens.size();
+				children();
+				return offsets[p + 1] - offsets[p];
 			}
 			return 0;
 		}
@@ -1245,22 +1595,24 @@ namespace xui
 		}
 		value_t item_data( xui::control_id id, int role ) override
 		{
-			if ( auto it = find( id ) )
+			auto h = handle( id );
+			if ( h >= 0 )
 			{
+				const auto & it = nodes[h];
 				switch ( role )
 				{
 				case xui::menu_model::ID:
-					return it->id;
+					return this->id( h );
 				case xui::menu_model::ICON:
-					return it->icon;
+					return it.icon;
 				case xui::menu_model::NAME:
-					return it->name;
+					return it.name;
 				case xui::menu_model::SHORTCUTS:
-					return it->shortcuts;
+					return it.shortcuts;
 				case xui::menu_model::IS_MENU:
-					return !it->childrens.empty();
+					return it.exit > h + 1;
 				case xui::menu_model::IS_SELECTED:
-					return it->selected;
+					return it.selected;
 				}
 			}
 			return {};
@@ -1269,47 +1621,97 @@ namespace xui
 		{
 			if ( role == xui::menu_model::IS_SELECTED )
 			{
-				if ( auto it = find( id ) )
+				auto h = handle( id );
+				if ( h >= 0 )
 				{
-					it->selected = std::get<bool>( val );
+					nodes[h].selected = std::get<bool>( val );
 				}
 			}
 		}
+		void fetch_rows( xui::control_id parent, int first, int count, std::span<const int> roles, item_batch & batch ) override
+		{
+			auto p = handle( parent );
+			auto rows = p >= 0 ? row_count( parent ) : 0;
+
+			batch.stride = (int)roles.size();
+			batch.values.resize( count * roles.size() );
+
+			for ( int i = 0; i < count; i++ )
+			{
+				auto h = first + i < rows ? children()[offsets[p] + first + i] : -1;
+				for ( int j = 0; j < batch.stride; j++ )
+					batch.values[i * batch.stride + j] = h >= 0 ? item_view( h, roles[j] ) : value_view();
+			}
+		}
 
 	private:
-		item * find( xui::control_id id ) const
+		value_view item_view( int h, int role ) const
 		{
-			if ( id.empty() )
-				return &root;
-
-			if ( id == root.id )
-				return &root;
+			const auto & it = nodes[h];
+			switch ( role )
+			{
+			case xui::menu_model::ID:
+				return id( h );
+			case xui::menu_model::ICON:
+				return it.icon;
+			case xui::menu_model::NAME:
+				return std::string_view( it.name );
+			case xui::menu_model::SHORTCUTS:
+				return std::string_view( it.shortcuts );
+			case xui::menu_model::IS_MENU:
+				return it.exit > h + 1;
+			case xui::menu_model::IS_SELECTED:
+				return it.selected;
+			}
+			return {};
+		}
+		int append( std::string_view name, xui::texture_id icon, std::string_view shortcuts )
+		{
+			// the stack is the rightmost path, so appending keeps pre-order and only its intervals grow
+			int h = (int)nodes.size();
 
-			if ( id.size() <= root.id.size() )
-				return nullptr;
+			auto & it = nodes.emplace_back();
+			it.name = name;
+			it.icon = icon;
+			it.shortcuts = shortcuts;
+			it.parent = stack.back();
+			it.exit = h + 1;
 
-			item * result = &root;
+			for ( auto s : stack )
+				nodes[s].exit = h + 1;
 
-			auto beg = id.begin() + root.id.size() + 1;
-			auto end = std::find( beg, id.end(), '_' );
+			offsets.clear();
+			bump_revision();
 
-			while ( beg != id.end() )
+			return h;
+		}
+		// children grouped by parent, offsets[h] .. offsets[h + 1] index the children of h in order
+		const std::vector<int> & children() const
+		{
+			if ( offsets.empty() )
 			{
-				size_t i = 0;
-				std::from_chars( beg.operator->(), beg.operator->() + std::distance( beg, end ), i );
-				result = result->childrens[i];
-
-				beg = end;
-				if ( end != id.end() ) beg += 1;
-				end = std::find( beg, id.end(), '_' );
+				offsets.assign( nodes.size() + 1, 0 );
+				for ( std::size_t i = 1; i < nodes.size(); i++ )
+					offsets[nodes[i].parent + 1]++;
+				for ( std::size_t i = 0; i < nodes.size(); i++ )
+					offsets[i + 1] += offsets[i];
+
+				child_list.resize( nodes.size() );
+				std::vector<int> pos( offsets.begin(), offsets.end() - 1 );
+				for ( std::size_t i = 1; i < nodes.size(); i++ )
+					child_list[pos[nodes[i].parent]++] = (int)i;
 			}
 
-			return result;
+			return child_list;
 		}
 
 	public:
-		mutable item root;
-		std::vector<item *> stack;
+		std::vector<item> nodes;
+		std::vector<int> stack;
+
+	private:
+		mutable std::vector<int> offsets;
+		mutable std::vector<int> child_list;
 	};
 
 	class menubar_model : public item_model
@@ -1332,11 +1734,11 @@ namespace xui
 			std::string name = {};
 			std::string shortcuts = {};
 			menu_model * menu = nullptr;
-			std::string id;
+			xui::control_id id;
 		};
 
 	public:
-		menubar_model( std::string_view cid )
+		menubar_model( xui::control_id cid )
 			: item_model( cid )
 		{ }
 
@@ -1345,12 +1747,14 @@ namespace xui
 		{
 			items.push_back( {} );
 
-			items.back().id = std::format( "{}_{}", control_id, items.size() - 1 );
+			items.back().id = control_id.child( items.size() - 1 );
 			items.back().name = name;
 			items.back().icon = icon;
 			items.back().menu = new menu_model( items.back().id );
 			items.back().shortcuts = shortcuts;
 
+			bump_revision();
+
 			return items.back().menu;
 		}
 
@@ -1441,6 +1845,30 @@ namespace xui
 				}
 			}
 		}
+		void fetch_rows( xui::control_id parent, int first, int count, std::span<const int> roles, item_batch & batch ) override
+		{
+			batch.stride = (int)roles.size();
+			batch.values.resize( count * roles.size() );
+
+			for ( int i = 0; i < count; i++ )
+			{
+				const item * it = first + i < (int)items.size() ? &items[first + i] : nullptr;
+				for ( int j = 0; j < batch.stride; j++ )
+				{
+					auto & val = batch.values[i * batch.stride + j];
+					switch ( it ? roles[j] : -1 )
+					{
+					case xui::menubar_model::ID: val = it->id; break;
+					case xui::menubar_model::ICON: val = it->icon; break;
+					case xui::menubar_model::NAME: val = std::string_view( it->name ); break;
+					case xui::menubar_model::MENUMODEL: val = (xui::item_model *)it->menu; break;
+					case xui::menubar_model::SHORTCUTS: val = std::string_view( it->shortcuts ); break;
+					case xui::menubar_model::IS_SELECTED: val = it->selected; break;
+					default: val = {}; break;
+					}
+				}
+			}
+		}
 
 	public:
 		item * find( xui::control_id id ) const
@@ -1448,20 +1876,10 @@ namespace xui
 			if ( id.empty() )
 				return nullptr;
 
-			if ( id == control_id )
-				return nullptr;
-
-			if ( id.size() <= control_id.size() )
-				return nullptr;
-
-			auto beg = id.begin() + control_id.size() + 1;
-			auto end = std::find( beg, id.end(), '_' );
-
-			if ( beg != id.end() )
+			for ( auto & it : items )
 			{
-				size_t i = 0;
-				std::from_chars( beg.operator->(), beg.operator->() + std::distance( beg, end ), i );
-				return &items[i];
+				if ( it.id == id )
+					return &it;
 			}
 
 			return nullptr;
@@ -1471,6 +1889,628 @@ namespace xui
 		mutable std::vector<item> items;
 	};
 
+	class listview_model : public item_model
+	{
+	public:
+		enum role_type
+		{
+			ID,
+			ICON,
+			NAME,
+			IS_SELECTED,
+		};
+
+	public:
+		listview_model( xui::control_id cid )
+			: item_model( cid )
+		{
+		}
+
+	public:
+		bool item_exist( int row, int col, xui::control_id parent ) const override
+		{
+			return row >= 0 && row < row_count( parent ) && col == 0;
+		}
+		xui::control_id index( int row, int col, xui::control_id parent ) const override
+		{
+			return control_id.child( row );
+		}
+		int col_count( xui::control_id parent ) const override
+		{
+			return 1;
+		}
+
+	public:
+		// uniform rows are all row_height( 0 ) tall, the listview style height is used when that is 0
+		virtual bool uniform_rows() const
+		{
+			return true;
+		}
+		virtual float row_height( int row ) const
+		{
+			return item_size_hint().h;
+		}
+
+	public:
+		// rows within reach of the measured ones are summed exactly, a jump further away measures a window of rows at an estimated offset
+		double row_offset( int row ) const
+		{
+			auto count = row_count( {} );
+			row = std::clamp( row, 0, count );
+			sync( count );
+
+			if ( !_window.empty() && row >= _window_row && row <= window_end() + extend_rows )
+			{
+				while ( window_end() < row )
+					_window.push_back( _window.back() + row_height( window_end() ) );
+
+				return _window[row - _window_row];
+			}
+			if ( row <= known() + extend_rows && ( _window.empty() || row < _window_row ) )
+			{
+				while ( known() < row )
+					_offsets.push_back( _offsets.back() + row_height( known() ) );
+
+				return _offsets[row];
+			}
+
+			return estimate( row );
+		}
+		int row_at( double offset ) const
+		{
+			auto count = row_count( {} );
+			if ( count <= 0 )
+				return 0;
+
+			sync( count );
+			offset = std::max( offset, 0.0 );
+
+			if ( offset < _offsets.back() )
+				return search( _offsets, offset, count );
+
+			double reach = extend_rows * average();
+			if ( !_window.empty() && offset >= _window.front() - reach && ( offset < _window.back() + reach || window_end() >= count ) )
+			{
+				while ( offset < _window.front() && _window_row > known() )
+				{
+					_window_row--;
+					_window.push_front( _window.front() - row_height( _window_row ) );
+				}
+				if ( _window_row == known() )
+				{
+					merge();
+					return row_at( offset );
+				}
+
+				while ( offset >= _window.back() && window_end() < count )
+					_window.push_back( _window.back() + row_height( window_end() ) );
+
+				return _window_row + search( _window, offset, count - _window_row );
+			}
+
+			if ( offset < _offsets.back() + reach && ( _window.empty() || offset < _window.front() ) )
+			{
+				for ( int i = 0; i < extend_rows && offset >= _offsets.back() && known() < count; i++ )
+				{
+					if ( !_window.empty() && known() == _window_row )
+						merge();
+					else
+						_offsets.push_back( _offsets.back() + row_height( known() ) );
+				}
+
+				if ( offset < _offsets.back() || known() >= count )
+					return search( _offsets, offset, count );
+			}
+
+			if ( known() + 1 >= count )
+			{
+				while ( known() < count )
+					_offsets.push_back( _offsets.back() + row_height( known() ) );
+
+				return search( _offsets, offset, count );
+			}
+
+			// too far to measure up to, the new window starts where estimate() puts the offset
+			int base = known();
+			double base_offset = _offsets.back(), slope = average();
+			if ( !_window.empty() && offset >= _window.front() )
+			{
+				base = window_end();
+				base_offset = _window.back();
+			}
+			else if ( !_window.empty() )
+			{
+				slope = ( _window.front() - _offsets.back() ) / ( _window_row - known() );
+			}
+
+			auto rows = std::min( ( offset - base_offset ) / slope, double( count - base ) );
+			auto row = std::clamp( base + int( rows ), known() + 1, count - 1 );
+			_window.assign( 1, base_offset + ( row - base ) * slope );
+			_window_row = row;
+
+			while ( offset >= _window.back() && window_end() < count )
+				_window.push_back( _window.back() + row_height( window_end() ) );
+
+			return _window_row + search( _window, offset, count - _window_row );
+		}
+		double total_height() const
+		{
+			auto count = row_count( {} );
+			sync( count );
+
+			if ( _window.empty() && count - known() <= extend_rows )
+			{
+				while ( known() < count )
+					_offsets.push_back( _offsets.back() + row_height( known() ) );
+			}
+
+			if ( known() >= count )
+				return _offsets[count];
+			if ( !_window.empty() && window_end() >= count )
+				return _window[count - _window_row];
+
+			return estimate( count );
+		}
+		void invalidate_rows( int row = 0 )
+		{
+			bump_revision();
+			if ( row + 1 < (int)_offsets.size() )
+				_offsets.resize( std::max( row, 0 ) + 1 );
+			if ( !_window.empty() && row <= window_end() )
+				_window.clear();
+		}
+
+	private:
+		static constexpr int extend_rows = 1024;
+
+		int known() const
+		{
+			return (int)_offsets.size() - 1;
+		}
+		int window_end() const
+		{
+			return _window_row + (int)_window.size() - 1;
+		}
+		void sync( int count ) const
+		{
+			if ( _offsets.empty() )
+				_offsets.push_back( 0 );
+			if ( known() > count )
+				_offsets.resize( count + 1 );
+			if ( !_window.empty() && window_end() > count )
+				_window.clear();
+		}
+		// the window is moved so its first row continues the prefix
+		void merge() const
+		{
+			double delta = _offsets.back() - _window.front();
+			for ( std::size_t i = 1; i < _window.size(); i++ )
+				_offsets.push_back( _window[i] + delta );
+
+			_window.clear();
+		}
+		double average() const
+		{
+			auto measured = known() + ( _window.empty() ? 0 : (int)_window.size() - 1 );
+			auto sum = _offsets.back() + ( _window.empty() ? 0 : _window.back() - _window.front() );
+			if ( measured > 0 && sum > 0 )
+				return sum / measured;
+
+			return row_height( 0 ) > 0 ? row_height( 0 ) : 1.0;
+		}
+		// rows between the prefix and the window are interpolated, rows after both use the average
+		double estimate( int row ) const
+		{
+			if ( !_window.empty() && row < _window_row )
+				return _offsets.back() + ( row - known() ) * ( _window.front() - _offsets.back() ) / ( _window_row - known() );
+			if ( !_window.empty() )
+				return _window.back() + ( row - window_end() ) * average();
+
+			return _offsets.back() + ( row - known() ) * average();
+		}
+		template<typename T> static int search( const T & offsets, double offset, int count )
+		{
+			auto row = int( std::upper_bound( offsets.begin(), offsets.end(), offset ) - offsets.begin() ) - 1;
+			return std::clamp( row, 0, std::max( count - 1, 0 ) );
+		}
+
+	private:
+		mutable int _window_row = 0;
+		mutable std::vector<double> _offsets;
+		mutable std::deque<double> _window;
+	};
+
+	class treeview_model : public item_model
+	{
+	public:
+		enum role_type
+		{
+			ID,
+			ICON,
+			NAME,
+			IS_SELECTED,
+		};
+
+		struct node
+		{
+			xui::control_id id;
+			int depth = 0;
+			bool expanded = false;
+		};
+
+	public:
+		treeview_model( xui::control_id cid )
+			: item_model( cid )
+		{
+		}
+
+	public:
+		bool item_exist( int row, int col, xui::control_id parent ) const override
+		{
+			return row >= 0 && row < row_count( parent ) && col == 0;
+		}
+		xui::control_id index( int row, int col, xui::control_id parent ) const override
+		{
+			return parent.empty() ? control_id.child( row ) : parent.child( row );
+		}
+		int col_count( xui::control_id parent ) const override
+		{
+			return 1;
+		}
+
+	public:
+		// rows currently shown in display order, children are read from the model only when their parent expands
+		std::span<const node> visible_nodes() const
+		{
+			if ( !_built )
+			{
+				_built = true;
+				_nodes.clear();
+				insert_children( 0, {}, 0 );
+			}
+
+			return _nodes;
+		}
+		bool has_children( int row ) const
+		{
+			auto nodes = visible_nodes();
+			return row >= 0 && row < (int)nodes.size() && row_count( nodes[row].id ) > 0;
+		}
+		void expand( int row )
+		{
+			auto nodes = visible_nodes();
+			if ( row < 0 || row >= (int)nodes.size() || nodes[row].expanded )
+				return;
+
+			_nodes[row].expanded = true;
+			_expanded.insert( _nodes[row].id.hash() );
+			insert_children( row + 1, _nodes[row].id, _nodes[row].depth + 1 );
+			bump_revision();
+		}
+		void collapse( int row )
+		{
+			auto nodes = visible_nodes();
+			if ( row < 0 || row >= (int)nodes.size() || !nodes[row].expanded )
+				return;
+
+			auto end = row + 1;
+			while ( end < (int)_nodes.size() && _nodes[end].depth > _nodes[row].depth )
+				++end;
+
+			_nodes[row].expanded = false;
+			_expanded.erase( _nodes[row].id.hash() );
+			_nodes.erase( _nodes.begin() + row + 1, _nodes.begin() + end );
+			bump_revision();
+		}
+		void toggle( int row )
+		{
+			auto nodes = visible_nodes();
+			if ( row >= 0 && row < (int)nodes.size() )
+				nodes[row].expanded ? collapse( row ) : expand( row );
+		}
+		// call after the tree structure changed, expanded nodes stay expanded
+		void invalidate()
+		{
+			_built = false;
+			bump_revision();
+		}
+
+	private:
+		void insert_children( std::size_t pos, xui::control_id parent, int depth ) const
+		{
+			std::vector<node> rows;
+			collect( rows, parent, depth );
+			_nodes.insert( _nodes.begin() + pos, rows.begin(), rows.end() );
+		}
+		void collect( std::vector<node> & rows, xui::control_id parent, int depth ) const
+		{
+			auto count = row_count( parent );
+			for ( int i = 0; i < count; i++ )
+			{
+				auto id = index( i, 0, parent );
+				bool expanded = _expanded.count( id.hash() ) != 0;
+
+				rows.push_back( { id, depth, expanded } );
+				if ( expanded )
+					collect( rows, id, depth + 1 );
+			}
+		}
+
+	private:
+		mutable bool _built = false;
+		mutable std::vector<node> _nodes;
+		std::unordered_set<std::size_t> _expanded;
+	};
+
+	class tableview_model : public item_model
+	{
+	private:
+		using sort_value = std::variant<std::monostate, double, std::string>;
+
+	public:
+		enum role_type
+		{
+			ID,
+			NAME,
+			IS_SELECTED,
+		};
+
+	public:
+		tableview_model( xui::control_id cid )
+			: item_model( cid )
+		{
+		}
+
+	public:
+		bool item_exist( int row, int col, xui::control_id parent ) const override
+		{
+			return row >= 0 && row < row_count( parent ) && col >= 0 && col < col_count( parent );
+		}
+		xui::control_id index( int row, int col, xui::control_id parent ) const override
+		{
+			return control_id.child( row ).child( col );
+		}
+
+	public:
+		virtual float col_width( int col ) const
+		{
+			return 100;
+		}
+		// leading columns that stay in place while scrolling horizontally
+		virtual int frozen_cols() const
+		{
+			return 0;
+		}
+		virtual value_t sort_key( int row, int col )
+		{
+			return item_data( index( row, col, {} ), NAME );
+		}
+		virtual bool filter_row( int row )
+		{
+			return true;
+		}
+
+	public:
+		int sort_col() const
+		{
+			return _sort_col;
+		}
+		bool sort_ascending() const
+		{
+			return _ascending;
+		}
+		// rows that pass the filter, in sorted order
+		int view_count()
+		{
+			build();
+			return (int)_order.size();
+		}
+		int source_row( int view_row )
+		{
+			build();
+			return _order[view_row];
+		}
+		bool is_filtered( int row )
+		{
+			build();
+			return !_accepted[row];
+		}
+
+	public:
+		void sort( int col, bool ascending = true )
+		{
+			bump_revision();
+
+			if ( _built && col == _sort_col )
+			{
+				// ties are broken by source row in both directions, so flipping is an exact reverse
+				if ( ascending != _ascending )
+					std::reverse( _order.begin(), _order.end() );
+				_ascending = ascending;
+				return;
+			}
+
+			_sort_col = col;
+			_ascending = ascending;
+			_keys.clear();
+
+			if ( _built )
+			{
+				if ( _sort_col >= 0 )
+				{
+					_keys.resize( _accepted.size() );
+					for ( int i = 0; i < (int)_keys.size(); i++ )
+						_keys[i] = make_key( sort_key( i, _sort_col ) );
+				}
+				sort_order();
+			}
+		}
+		// the filter predicate changed, re-evaluates every row but keeps the cached sort keys
+		void refilter()
+		{
+			bump_revision();
+
+			if ( !_built )
+				return;
+
+			_order.clear();
+			for ( int i = 0; i < (int)_accepted.size(); i++ )
+			{
+				_accepted[i] = filter_row( i );
+				if ( _accepted[i] )
+					_order.push_back( i );
+			}
+			sort_order();
+		}
+		void insert_rows( int first, int count )
+		{
+			bump_revision();
+
+			if ( !_built )
+				return;
+
+			if ( count > (int)_order.size() / 16 + 1 )
+				return invalidate();
+
+			for ( auto & row : _order )
+			{
+				if ( row >= first )
+					row += count;
+			}
+			_accepted.insert( _accepted.begin() + first, count, false );
+			if ( _sort_col >= 0 )
+				_keys.insert( _keys.begin() + first, count, sort_value() );
+
+			for ( int i = first; i < first + count; i++ )
+				place( i );
+		}
+		void remove_rows( int first, int count )
+		{
+			bump_revision();
+
+			if ( !_built )
+				return;
+
+			std::erase_if( _order, [&]( int row ) { return row >= first && row < first + count; } );
+			for ( auto & row : _order )
+			{
+				if ( row >= first + count )
+					row -= count;
+			}
+			_accepted.erase( _accepted.begin() + first, _accepted.begin() + first + count );
+			if ( _sort_col >= 0 )
+				_keys.erase( _keys.begin() + first, _keys.begin() + first + count );
+		}
+		// the row's data changed, moves it to its new sorted position or in/out of the filter
+		void update_row( int row )
+		{
+			bump_revision();
+
+			if ( !_built )
+				return;
+
+			if ( _accepted[row] )
+				_order.erase( std::find( _order.begin(), _order.end(), row ) );
+
+			place( row );
+		}
+		void invalidate()
+		{
+			_built = false;
+			bump_revision();
+		}
+
+	private:
+		void build()
+		{
+			if ( _built )
+				return;
+
+			_built = true;
+			auto count = row_count( {} );
+
+			_order.clear();
+			_accepted.assign( count, false );
+			_keys.clear();
+			if ( _sort_col >= 0 )
+				_keys.resize( count );
+
+			for ( int i = 0; i < count; i++ )
+			{
+				_accepted[i] = filter_row( i );
+				if ( _sort_col >= 0 )
+					_keys[i] = make_key( sort_key( i, _sort_col ) );
+				if ( _accepted[i] )
+					_order.push_back( i );
+			}
+
+			if ( _sort_col >= 0 )
+				sort_order();
+		}
+		void place( int row )
+		{
+			_accepted[row] = filter_row( row );
+			if ( _sort_col >= 0 )
+				_keys[row] = make_key( sort_key( row, _sort_col ) );
+
+			if ( _accepted[row] )
+				_order.insert( std::upper_bound( _order.begin(), _order.end(), row, [this]( int a, int b ) { return order_less( a, b ); } ), row );
+		}
+		void sort_order()
+		{
+			if ( _sort_col < 0 )
+				return std::sort( _order.begin(), _order.end(), [this]( int a, int b ) { return order_less( a, b ); } );
+
+			// keys are gathered next to their rows so the sort walks contiguous memory instead of chasing _keys
+			std::vector<std::pair<sort_value, int>> items;
+			items.reserve( _order.size() );
+			for ( auto row : _order )
+				items.emplace_back( std::move( _keys[row] ), row );
+
+			if ( _ascending )
+				std::sort( items.begin(), items.end() );
+			else
+				std::sort( items.begin(), items.end(), []( const auto & a, const auto & b ) { return b < a; } );
+
+			for ( std::size_t i = 0; i < items.size(); i++ )
+			{
+				_order[i] = items[i].second;
+				_keys[_order[i]] = std::move( items[i].first );
+			}
+		}
+		bool order_less( int a, int b ) const
+		{
+			if ( !_ascending )
+				std::swap( a, b );
+
+			if ( _sort_col >= 0 )
+			{
+				if ( _keys[a] < _keys[b] ) return true;
+				if ( _keys[b] < _keys[a] ) return false;
+			}
+
+			return a < b;
+		}
+		// numbers compare as double, values that have no order sort first
+		static sort_value make_key( const value_t & val )
+		{
+			if ( auto v = std::get_if<int>( &val ) ) return double( *v );
+			if ( auto v = std::get_if<float>( &val ) ) return double( *v );
+			if ( auto v = std::get_if<bool>( &val ) ) return double( *v );
+			if ( auto v = std::get_if<std::string>( &val ) ) return *v;
+
+			return {};
+		}
+
+	private:
+		bool _built = false;
+		int _sort_col = -1;
+		bool _ascending = true;
+		std::vector<int> _order;
+		std::vector<bool> _accepted;
+		std::vector<sort_value> _keys;
+	};
+
 
 	inline xui::vec2				operator-( const xui::vec2 & lhs )
 	{